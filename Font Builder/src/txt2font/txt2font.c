@@ -17,9 +17,11 @@ ASCIIDef_t  font[ASCII_SIZE] = { 0 };
 // Code ----------------------
 void usage(void)
 {
-  printf("\nusage: txt2font <root_name>\n");
+  printf("\nusage: txt2font [-s] <root_name>\n");
   printf("\n\ninput file  <root_name>.txt");
   printf("\noutput file <root_name>.h");
+  printf("\n\n-s always write the sparse (version 3) font format");
+  printf("\n   (used anyway if any character code is more than 255)");
   printf("\n");
 
   return;
@@ -28,6 +30,14 @@ void usage(void)
 int cmdLine(int argc, char *argv[])
 // process the command line parameter
 {
+  G.sparse = 0;
+  if (argc == 3 && strcmp(argv[1], "-s") == 0)
+  {
+    G.sparse = 1;
+    argc--;
+    argv++;
+  }
+
   if (argc != 2)
     return(1);
 
@@ -47,6 +57,7 @@ int initialise(void)
     font[i].comment[0] = NUL;
     font[i].size = 0;
     font[i].buf = NULL;
+    font[i].defined = 0;
   }
 
   // open the file for reading
@@ -126,9 +137,10 @@ unsigned int normaliseBuffers(void)
 char *getToken(char *buf)
 // isolate the first token in the buffer and return a pointer to the next non white space after the token
 {
-  while (!isspace(*buf))
+  while (*buf != NUL && !isspace(*buf))
     buf++;
-  *buf++ = NUL;
+  if (*buf != NUL)  // token may be the whole buffer
+    *buf++ = NUL;
   while (isspace(*buf))
     buf++;
 
@@ -154,6 +166,7 @@ void createFontChar(void)
     font[G.curCode+DOUBLE_HEIGHT_OFFSET].buf = malloc(font[G.curCode].size * sizeof(*font[0].buf));
 
     font[G.curCode+DOUBLE_HEIGHT_OFFSET].size = font[G.curCode].size;
+    font[G.curCode+DOUBLE_HEIGHT_OFFSET].defined = 1;
     strcpy(font[G.curCode+DOUBLE_HEIGHT_OFFSET].comment, font[G.curCode].comment);
   }
 
@@ -271,11 +284,14 @@ void readInput(void)
         if (strcmp(&inLine[1], CMD_END) != 0)
         {
           G.curBuf = 0;
-          G.curCode = atoi(cp);
+          if (cp[0] == '0' && (cp[1] == 'x' || cp[1] == 'X'))
+            G.curCode = strtoul(cp, NULL, 16);
+          else
+            G.curCode = atoi(cp);
 #ifdef DEBUG
           printf("\t set up %02x", G.curCode);
 #endif
-          if (G.curCode >= (G.doubleHeight ? ASCII_SIZE/2 : ASCII_SIZE))
+          if (G.curCode >= (G.doubleHeight ? DOUBLE_HEIGHT_OFFSET : ASCII_SIZE))
           {
             G.curCode = 0;
 #ifdef DEBUG
@@ -284,6 +300,7 @@ void readInput(void)
           }
           font[G.curCode].comment[0] = NUL;
           font[G.curCode].size = 0;
+          font[G.curCode].defined = 1;
         }
 #ifdef DEBUG
         else
@@ -307,14 +324,95 @@ void readInput(void)
   return;
 }
 
-void saveOutput(void)
+void saveChar(int i)
+// save the size and column data for one character
+{
+  fprintf(G.fpOut, "\t%d,", font[i].size);
+  if (font[i].buf != NULL)
+  {
+    for (unsigned int j=0; j<font[i].size; j++)
+      fprintf(G.fpOut, (DECIMAL_DATA ? "%d," : "0x%02x,"), font[i].buf[j]);
+  }
+  fprintf(G.fpOut, "\t// %d", i);
+  if (font[i].comment[0] != NUL)
+    fprintf(G.fpOut," - %s", font[i].comment);
+  fprintf(G.fpOut, "\n");
+}
+
+int saveSparse(void)
+// save the font table in the sparse (version 3) format - a table of the ranges
+// of consecutive character codes defined, a directory with the offset of each
+// character in the ranges and then the character data
+{
+  unsigned int ranges = 0, count = 0, offset = 0;
+  int first = -1;
+
+  // count the ranges and characters, and check the offsets fit in 16 bits
+  for (int i=0; i<ASCII_SIZE; i++)
+  {
+    if (!font[i].defined) continue;
+    if (i == 0 || !font[i-1].defined) ranges++;
+    if (offset >= SPARSE_DATA_MAX)
+    {
+      printf("\nToo much character data for the sparse font format\n");
+      return(1);
+    }
+    offset += font[i].size + 1;
+    count++;
+  }
+  if (5 + (ranges * SPARSE_RANGE_SIZE) + (count * 2) >= SPARSE_DATA_MAX)
+  {
+    printf("\nToo many characters for the sparse font format\n");
+    return(1);
+  }
+
+  fprintf(G.fpOut, "'F', 3, %d, %d, %d,\n", G.fontHeight, ranges >> 8, ranges & 0xff);
+
+  // range table - first code, last code, directory entry for first code
+  fprintf(G.fpOut, "// ranges\n");
+  count = 0;
+  for (int i=0; i<ASCII_SIZE; i++)
+  {
+    if (!font[i].defined) continue;
+    if (first == -1) first = i;
+    if (i == ASCII_SIZE-1 || !font[i+1].defined)
+    {
+      fprintf(G.fpOut, "\t%d, %d, %d, %d, %d, %d,\t// %d - %d\n", 
+        first >> 8, first & 0xff, i >> 8, i & 0xff, count >> 8, count & 0xff, first, i);
+      count += i - first + 1;
+      first = -1;
+    }
+  }
+
+  // directory - offset of each character from the start of the character data
+  fprintf(G.fpOut, "// directory\n");
+  offset = 0;
+  for (int i=0; i<ASCII_SIZE; i++)
+  {
+    if (!font[i].defined) continue;
+    fprintf(G.fpOut, "\t%d, %d,\t// %d\n", offset >> 8, offset & 0xff, i);
+    offset += font[i].size + 1;
+  }
+
+  // character data
+  fprintf(G.fpOut, "// characters\n");
+  for (int i=0; i<ASCII_SIZE; i++)
+    if (font[i].defined) saveChar(i);
+
+  return(0);
+}
+
+int saveOutput(void)
 // save the current definition as a font definition header file
 {
-  unsigned int minAscii = 0, maxAscii = 0;
+  unsigned int minAscii = 0, maxAscii = 0, maxDefined = 0;
   
   // first parse the font table to work out the min and max ASCII values
   for (int i=0; i<ASCII_SIZE; i++)
+  {
     if (font[i].buf != NULL) maxAscii = i;
+    if (font[i].defined) maxDefined = i;
+  }
     
   for (int i=maxAscii; i>=0; i--)
     if (font[i].buf != NULL) minAscii = i;
@@ -329,24 +427,24 @@ void saveOutput(void)
 
   fprintf(G.fpOut, "#pragma once\n\n");
   fprintf(G.fpOut, "const uint8_t PROGMEM _%s[] = \n{\n", (G.name[0] == NUL) ? "font" : G.name);
-  fprintf(G.fpOut, "'F', 1, %d, %d, %d,\n", minAscii, maxAscii, G.fontHeight);
-
 
-  for (int i=minAscii; i<=maxAscii; i++)
+  // 16 bit character codes need the sparse format
+  if (G.sparse || maxDefined > 255)
   {
-    fprintf(G.fpOut, "\t%d,", font[i].size);
-    if (font[i].buf != NULL)
-    {
-      for (unsigned int j=0; j<font[i].size; j++)
-        fprintf(G.fpOut, (DECIMAL_DATA ? "%d," : "0x%02x,"), font[i].buf[j]);
-    }
-    fprintf(G.fpOut, "\t// %d", i);
-    if (font[i].comment[0] != NUL)
-      fprintf(G.fpOut," - %s", font[i].comment);
-    fprintf(G.fpOut, "\n");
+    if (saveSparse() != 0)
+      return(4);
+  }
+  else
+  {
+    fprintf(G.fpOut, "'F', 1, %d, %d, %d,\n", minAscii, maxAscii, G.fontHeight);
+
+    for (int i=minAscii; i<=maxAscii; i++)
+      saveChar(i);
   }
 
   fprintf(G.fpOut, "};\n\n");
+
+  return(0);
   }
 
   int main(int argc, char *argv[])
@@ -366,11 +464,11 @@ void saveOutput(void)
   readInput();
 
   // write the output file
-  saveOutput();
+  ret = saveOutput();
 
   // close files and exit
   fclose(G.fpIn);
   fclose(G.fpOut);
 
-  return(0);
+  return(ret);
   }
@@ -18,11 +18,13 @@
 #define FILE_NAME_SIZE    200 // may include path
 #define FONT_NAME_SIZE    50
 #define COMMENT_SIZE      40
-#define ASCII_SIZE        256
+#define ASCII_SIZE        65536 // 16 bit character codes
 #define INPUT_BUFFER_SIZE 200
 
 #define SINGLE_HEIGHT 8
-#define DOUBLE_HEIGHT_OFFSET  (ASCII_SIZE/2)  // ASCII code offset
+#define DOUBLE_HEIGHT_OFFSET  128  // ASCII code offset
+#define SPARSE_RANGE_SIZE     6    // bytes in each range table entry
+#define SPARSE_DATA_MAX       65536 // sparse directory offsets are 16 bit
 
 #define IN_FILE_EXT   ".txt"
 #define OUT_FILE_EXT  ".h"
@@ -47,6 +49,7 @@ typedef struct
   FILE  *fpIn;
   FILE  *fpOut;
   char  fileRoot[FILE_NAME_SIZE];
+  unsigned int sparse;       // 1 to always write the sparse (version 3) format
 
   // font definition header
   char  name[FONT_NAME_SIZE];
@@ -67,5 +70,6 @@ typedef struct
   char comment[COMMENT_SIZE]; // comment for this character
   unsigned int size;  // number of valid
   unsigned int *buf;  // size bytes allocated from memory
+  unsigned int defined; // 1 if the character is in the definition file
 
   } ASCIIDef_t, *pASCIIDef_t;
@@ -0,0 +1,520 @@
+// Program to benchmark the MD_MAX72XX library
+//
+// Measures the processor time, SPI bytes, CS pulses (messages) and SPI
+// transactions used by the main library functions for different numbers
+// of devices, for every hardware module type and with the UPDATE control
+// ON and OFF.
+//
+// The display data is sent to an MD_MAX72XX_MockSPI transport, so no
+// hardware is required and the counts are independent of the SPI clock.
+// The byte and message counts are fixed for a given library version and
+// can be compared between versions to detect changes in the data sent.
+//
+// The results are printed as comma separated values on the serial
+// monitor, one line for each test:
+//   module type, devices, update mode, test, calls, time [us], bytes, CS pulses, transactions
+// Tests that need more RAM than available are reported as skipped.
+//
+// The pixel, row and column methods are then timed for one module type
+// using the MD_MAX72XX class and the MD_MAX72XX_T class template, which
+// has the module type fixed at compile time. These are reported with
+// "_T" added to the module type name.
+//
+// This sketch can also be compiled and run on the development computer
+// as a library host build, for example:
+//   g++ -x c++ -I<library>/src MD_MAX72xx_Benchmark.ino <library>/src/*.cpp
+//
+#include <MD_MAX72xx.h>
+
+#if !defined(ARDUINO)
+// Just enough of the Arduino environment to run on the development computer
+#include <stdio.h>
+#include <chrono>
+
+#define F(s) (s)
+
+uint32_t micros(void)
+{
+  static auto start = std::chrono::steady_clock::now();
+
+  return((uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+class hostSerial
+{
+public:
+  void begin(uint32_t) {};
+  void print(const char *s) { printf("%s", s); };
+  void print(uint32_t n) { printf("%lu", (unsigned long)n); };
+  void println(void) { printf("\n"); };
+};
+
+hostSerial Serial;
+#endif
+
+// Define the number of times each test is repeated
+#define ITERATIONS 20
+
+// Define the module type used to compare the run time (MD_MAX72XX)
+// and compile time (MD_MAX72XX_T) module type classes
+#define TEMPLATE_TYPE MD_MAX72XX::PAROLA_HW
+#define TEMPLATE_NAME "PAROLA_HW"
+
+// Define the device counts to test. Larger displays may not fit
+// in the RAM of smaller processors and will be skipped.
+const uint8_t deviceCount[] = { 1, 8, 32, 150 };
+
+const char *moduleName[] =
+{
+  "GENERIC_HW", "FC16_HW", "PAROLA_HW", "ICSTATION_HW",
+  "DR0CR0RR0_HW", "DR0CR0RR1_HW", "DR0CR1RR0_HW", "DR0CR1RR1_HW",
+  "DR1CR0RR0_HW", "DR1CR0RR1_HW", "DR1CR1RR0_HW", "DR1CR1RR1_HW"
+};
+
+const char *transformName[] = { "TSL", "TSR", "TSU", "TSD", "TFLR", "TFUD", "TRC", "TINV" };
+const char *wrapName[] = { "TSL_WRAP", "TSR_WRAP", "TSU_WRAP", "TSD_WRAP" };
+const char *tileName[] = { "TSL_2D", "TSR_2D", "TSU_2D", "TSD_2D" };
+
+// Sprite used for the blit() tests
+const uint8_t sprite[COL_SIZE] = { 0x3c, 0x42, 0xa5, 0x81, 0xa5, 0x99, 0x42, 0x3c };
+
+// Data sent to the displays is counted by this transport
+MD_MAX72XX_MockSPI mock;
+
+// Accumulated test results
+struct result_t
+{
+  uint32_t calls;   // number of calls to the function tested
+  uint32_t time;    // total processor time in microseconds
+  uint32_t bytes;   // total SPI bytes sent
+  uint32_t pulses;  // total CS pulses (messages) sent
+  uint32_t trans;   // total SPI transactions
+};
+
+result_t result;
+uint32_t timeStart;
+
+void testStart(void)
+// Start timing a section of a test
+{
+  mock.reset();
+  timeStart = micros();
+}
+
+void testStop(uint32_t calls)
+// Stop timing a section of a test and add the results
+{
+  result.time += micros() - timeStart;
+  result.calls += calls;
+  result.bytes += mock.getBytes();
+  result.pulses += mock.getMessages();
+  result.trans += mock.getTransactions();
+}
+
+void testReport(const char *type, uint8_t devices, bool update, const char *test)
+// Print the test results and clear them for the next test
+{
+  Serial.print(type);
+  Serial.print(F(","));
+  Serial.print((uint32_t)devices);
+  Serial.print(update ? F(",ON,") : F(",OFF,"));
+  Serial.print(test);
+  Serial.print(F(","));
+  Serial.print(result.calls);
+  Serial.print(F(","));
+  Serial.print(result.time);
+  Serial.print(F(","));
+  Serial.print(result.bytes);
+  Serial.print(F(","));
+  Serial.print(result.pulses);
+  Serial.print(F(","));
+  Serial.print(result.trans);
+  Serial.println();
+
+  memset(&result, 0, sizeof(result));
+}
+
+void fillDisplay(MD_MAX72XX &mx)
+// Put a pattern in every column of the display and send it to
+// the devices. This is not included in the test results.
+{
+  mx.control(MD_MAX72XX::UPDATE, MD_MAX72XX::OFF);
+  for (uint16_t c = 0; c < mx.getColumnCount(); c++)
+    mx.setColumn(c, (uint8_t)(c * 37 + 11));
+  mx.update();
+}
+
+void runTests(uint8_t type, uint8_t devices, bool update)
+{
+  MD_MAX72XX mx((MD_MAX72XX::moduleType_t)type, mock, devices);
+  const uint16_t cols = devices * COL_SIZE;
+
+  if (!mx.begin())
+  {
+    Serial.print(moduleName[type]);
+    Serial.print(F(","));
+    Serial.print((uint32_t)devices);
+    Serial.print(update ? F(",ON,") : F(",OFF,"));
+    Serial.print(F("skipped - not enough memory"));
+    Serial.println();
+    return;
+  }
+
+  const MD_MAX72XX::controlValue_t mode = update ? MD_MAX72XX::ON : MD_MAX72XX::OFF;
+
+  // setPoint() on every pixel of the display
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+  {
+    mx.clear();
+    mx.control(MD_MAX72XX::UPDATE, mode);
+    testStart();
+    for (uint8_t r = 0; r < ROW_SIZE; r++)
+      for (uint16_t c = 0; c < cols; c++)
+        mx.setPoint(r, c, true);
+    testStop((uint32_t)ROW_SIZE * cols);
+  }
+  testReport(moduleName[type], devices, update, "setPoint");
+
+  // setColumn() on every column of the display
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+  {
+    mx.clear();
+    mx.control(MD_MAX72XX::UPDATE, mode);
+    testStart();
+    for (uint16_t c = 0; c < cols; c++)
+      mx.setColumn(c, 0x5a);
+    testStop(cols);
+  }
+  testReport(moduleName[type], devices, update, "setColumn");
+
+  // setRow() on every row of the display
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+  {
+    mx.clear();
+    mx.control(MD_MAX72XX::UPDATE, mode);
+    testStart();
+    for (uint8_t r = 0; r < ROW_SIZE; r++)
+      mx.setRow(r, 0x5a);
+    testStop(ROW_SIZE);
+  }
+  testReport(moduleName[type], devices, update, "setRow");
+
+#if USE_LOCAL_FONT
+  // setChar() across the width of the display
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+  {
+    mx.clear();
+    mx.control(MD_MAX72XX::UPDATE, mode);
+    testStart();
+    for (uint16_t n = 0; n < cols / 6; n++)
+      mx.setChar(cols - 1 - (n * 6), 'A' + (n % 26));
+    testStop(cols / 6);
+  }
+  testReport(moduleName[type], devices, update, "setChar");
+
+  // renderText() of the alphabet into a buffer, and getTextWidth() of the same text
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+  {
+    static uint8_t text[26 * 6];
+
+    testStart();
+    mx.renderText("ABCDEFGHIJKLMNOPQRSTUVWXYZ", text, sizeof(text));
+    testStop(1);
+  }
+  testReport(moduleName[type], devices, update, "renderText");
+
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+  {
+    testStart();
+    mx.getTextWidth("ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+    testStop(1);
+  }
+  testReport(moduleName[type], devices, update, "getTextWidth");
+#endif
+
+  // blit() of a sprite moving across the display, and the same
+  // sprite drawn with getPoint() and setPoint()
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+  {
+    mx.clear();
+    mx.control(MD_MAX72XX::UPDATE, mode);
+    testStart();
+    for (int16_t x = -1; x < cols + COL_SIZE; x++)
+      mx.blit(x, 0, COL_SIZE, ROW_SIZE, sprite, MD_MAX72XX::ROP_XOR);
+    testStop(cols + COL_SIZE + 1);
+  }
+  testReport(moduleName[type], devices, update, "blit");
+
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+  {
+    mx.clear();
+    mx.control(MD_MAX72XX::UPDATE, mode);
+    testStart();
+    for (int16_t x = -1; x < cols + COL_SIZE; x++)
+      for (uint8_t j = 0; j < COL_SIZE; j++)
+      {
+        if (x - j < 0 || x - j >= cols) continue;
+        for (uint8_t r = 0; r < ROW_SIZE; r++)
+          if (sprite[j] & (1 << r))
+            mx.setPoint(r, x - j, !mx.getPoint(r, x - j));
+      }
+    testStop(cols + COL_SIZE + 1);
+  }
+  testReport(moduleName[type], devices, update, "blitSetPoint");
+
+  // graphics primitives across the whole display
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+  {
+    mx.clear();
+    mx.control(MD_MAX72XX::UPDATE, mode);
+    testStart();
+    mx.drawLine(0, 0, ROW_SIZE - 1, cols - 1);
+    mx.drawLine(ROW_SIZE - 1, 0, 0, cols - 1);
+    testStop(2);
+  }
+  testReport(moduleName[type], devices, update, "drawLine");
+
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+  {
+    mx.clear();
+    mx.control(MD_MAX72XX::UPDATE, mode);
+    testStart();
+    mx.fillRect(1, 1, ROW_SIZE - 2, cols - 2);
+    testStop(1);
+  }
+  testReport(moduleName[type], devices, update, "fillRect");
+
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+  {
+    mx.clear();
+    mx.control(MD_MAX72XX::UPDATE, mode);
+    testStart();
+    for (uint16_t c = 0; c < cols; c += COL_SIZE)
+      mx.fillCircle(ROW_SIZE / 2, c + COL_SIZE / 2, 3);
+    testStop(devices);
+  }
+  testReport(moduleName[type], devices, update, "fillCircle");
+
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+  {
+    mx.clear();
+    mx.drawRect(0, 0, ROW_SIZE - 1, cols - 1);
+    mx.control(MD_MAX72XX::UPDATE, mode);
+    testStart();
+    mx.floodFill(ROW_SIZE / 2, cols / 2);
+    testStop(1);
+  }
+  testReport(moduleName[type], devices, update, "floodFill");
+
+  // transform() with each transformation
+  for (uint8_t t = MD_MAX72XX::TSL; t <= MD_MAX72XX::TINV; t++)
+  {
+    fillDisplay(mx);
+    mx.control(MD_MAX72XX::UPDATE, mode);
+    testStart();
+    for (uint8_t i = 0; i < ITERATIONS; i++)
+      mx.transform((MD_MAX72XX::transformType_t)t);
+    testStop(ITERATIONS);
+    testReport(moduleName[type], devices, update, transformName[t]);
+  }
+
+  // transform() with wraparound shifts
+  mx.control(MD_MAX72XX::WRAPAROUND, MD_MAX72XX::ON);
+  for (uint8_t t = MD_MAX72XX::TSL; t <= MD_MAX72XX::TSD; t++)
+  {
+    fillDisplay(mx);
+    mx.control(MD_MAX72XX::UPDATE, mode);
+    testStart();
+    for (uint8_t i = 0; i < ITERATIONS; i++)
+      mx.transform((MD_MAX72XX::transformType_t)t);
+    testStop(ITERATIONS);
+    testReport(moduleName[type], devices, update, wrapName[t]);
+  }
+  mx.control(MD_MAX72XX::WRAPAROUND, MD_MAX72XX::OFF);
+
+  // transform2D() and diagonal shift2D() shifts with the devices as 2 rows of tiles
+  if (devices % 2 == 0)
+  {
+    mx.setGeometry(devices / 2, 2, MD_MAX72XX::TILE_SERPENTINE);
+    for (uint8_t t = MD_MAX72XX::TSL; t <= MD_MAX72XX::TSD; t++)
+    {
+      fillDisplay(mx);
+      mx.control(MD_MAX72XX::UPDATE, mode);
+      testStart();
+      for (uint8_t i = 0; i < ITERATIONS; i++)
+        mx.transform2D((MD_MAX72XX::transformType_t)t);
+      testStop(ITERATIONS);
+      testReport(moduleName[type], devices, update, tileName[t]);
+    }
+
+    fillDisplay(mx);
+    mx.control(MD_MAX72XX::UPDATE, mode);
+    testStart();
+    for (uint8_t i = 0; i < ITERATIONS; i++)
+      mx.shift2D(-1, -1);
+    testStop(ITERATIONS);
+    testReport(moduleName[type], devices, update, "shift2D");
+    mx.setGeometry(0, 0);
+  }
+
+  // setViewport() scrolling the sprite repeated as a canvas, one column per call
+  mx.setCanvas(sprite, COL_SIZE);
+  mx.control(MD_MAX72XX::WRAPAROUND, MD_MAX72XX::ON);
+  mx.clear();
+  mx.control(MD_MAX72XX::UPDATE, mode);
+  testStart();
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+    mx.setViewport(i);
+  testStop(ITERATIONS);
+  testReport(moduleName[type], devices, update, "setViewport");
+  mx.control(MD_MAX72XX::WRAPAROUND, MD_MAX72XX::OFF);
+  mx.setCanvas(nullptr, 0);
+
+  // clear() of the whole display
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+  {
+    fillDisplay(mx);
+    mx.control(MD_MAX72XX::UPDATE, mode);
+    testStart();
+    mx.clear();
+    testStop(1);
+  }
+  testReport(moduleName[type], devices, update, "clear");
+
+  // update() with every device changed. With UPDATE ON the changes
+  // have already been sent, so only the checking time is measured.
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+  {
+    mx.control(MD_MAX72XX::UPDATE, mode);
+    mx.transform(MD_MAX72XX::TINV);
+    testStart();
+    mx.update();
+    testStop(1);
+  }
+  testReport(moduleName[type], devices, update, "update");
+
+  // commitFrame() and serviceFrame() with every device changed, two digit
+  // rows for each call. The time is for all the calls to send the frame.
+  mx.setFrameSlice(4 * devices, 0);
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+  {
+    uint32_t n = 1;
+
+    mx.control(MD_MAX72XX::UPDATE, mode);
+    mx.transform(MD_MAX72XX::TINV);
+    testStart();
+    mx.commitFrame();
+    while (mx.serviceFrame())
+      n++;
+    testStop(n);
+  }
+  testReport(moduleName[type], devices, update, "serviceFrame");
+}
+
+template <class T> void pixelTests(T &mx, const char *type, uint8_t devices)
+// Compare the pixel, row and column methods for the run time module
+// type (MD_MAX72XX) and the compile time module type (MD_MAX72XX_T).
+// UPDATE is OFF so that only the processing time is measured.
+{
+  const uint16_t cols = devices * COL_SIZE;
+  uint8_t x = 0;
+
+  if (!mx.begin())
+    return;
+  mx.control(MD_MAX72XX::UPDATE, MD_MAX72XX::OFF);
+
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+  {
+    testStart();
+    for (uint8_t r = 0; r < ROW_SIZE; r++)
+      for (uint16_t c = 0; c < cols; c++)
+        mx.setPoint(r, c, (r + c + i) & 1);
+    testStop((uint32_t)ROW_SIZE * cols);
+  }
+  testReport(type, devices, false, "setPoint");
+
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+  {
+    testStart();
+    for (uint8_t r = 0; r < ROW_SIZE; r++)
+      for (uint16_t c = 0; c < cols; c++)
+        x += mx.getPoint(r, c);
+    testStop((uint32_t)ROW_SIZE * cols);
+  }
+  testReport(type, devices, false, "getPoint");
+
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+  {
+    testStart();
+    for (uint16_t c = 0; c < cols; c++)
+      mx.setColumn(c, c + i);
+    testStop(cols);
+  }
+  testReport(type, devices, false, "setColumn");
+
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+  {
+    testStart();
+    for (uint16_t c = 0; c < cols; c++)
+      x += mx.getColumn(c);
+    testStop(cols);
+  }
+  testReport(type, devices, false, "getColumn");
+
+  for (uint8_t i = 0; i < ITERATIONS; i++)
+  {
+    testStart();
+    for (uint8_t d = 0; d < devices; d++)
+      for (uint8_t r = 0; r < ROW_SIZE; r++)
+        mx.setRow(d, r, d + r + i);
+    testStop((uint32_t)devices * ROW_SIZE);
+  }
+  testReport(type, devices, false, "setRow");
+
+  // use the result so the reads are not optimized away
+  if (x == 0) mx.clear();
+}
+
+void templateTests(uint8_t devices)
+// Run the pixel tests for the same module type selected at run and compile time
+{
+  MD_MAX72XX mxRun(TEMPLATE_TYPE, mock, devices);
+  pixelTests(mxRun, TEMPLATE_NAME, devices);
+
+  MD_MAX72XX_T<TEMPLATE_TYPE> mxT(mock, devices);
+  pixelTests(mxT, TEMPLATE_NAME "_T", devices);
+}
+
+void setup(void)
+{
+  Serial.begin(57600);
+  Serial.print(F("[MD_MAX72XX Benchmark]"));
+  Serial.println();
+  Serial.print(F("type,devices,update,test,calls,time,bytes,pulses,transactions"));
+  Serial.println();
+
+  for (uint8_t d = 0; d < sizeof(deviceCount) / sizeof(deviceCount[0]); d++)
+    for (uint8_t t = MD_MAX72XX::GENERIC_HW; t <= MD_MAX72XX::DR1CR1RR1_HW; t++)
+    {
+      runTests(t, deviceCount[d], true);
+      runTests(t, deviceCount[d], false);
+    }
+
+  for (uint8_t d = 0; d < sizeof(deviceCount) / sizeof(deviceCount[0]); d++)
+    templateTests(deviceCount[d]);
+
+  Serial.print(F("[Done]"));
+  Serial.println();
+}
+
+void loop(void)
+{
+}
+
+#if !defined(ARDUINO)
+int main(void)
+{
+  setup();
+  return(0);
+}
+#endif
@@ -0,0 +1,66 @@
+/*
+MD_MAX72xx - Library for using a MAX7219/7221 LED matrix controller
+
+Arduino core and SPI library stubs for the host computer build.
+
+Copyright (C) 2012-13 Marco Colli. All rights reserved.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <chrono>
+#include "Arduino.h"
+#include "SPI.h"
+
+SPIClass SPI;
+
+void pinMode(int8_t pin, uint8_t mode)
+{
+  (void)pin;
+  (void)mode;
+}
+
+void digitalWrite(int8_t pin, uint8_t value)
+// The device select going LOW starts a frame and going HIGH latches it
+{
+  if (value == LOW)
+    hostFrameStart();
+  else
+    hostFrameEnd(pin);
+}
+
+void shiftOut(int8_t dataPin, int8_t clkPin, uint8_t order, uint8_t value)
+{
+  (void)dataPin;
+  (void)clkPin;
+  (void)order;
+  hostSendByte(value);
+}
+
+unsigned long micros(void)
+{
+  static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  return(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+unsigned long millis(void)
+{
+  return(micros() / 1000);
+}
+
+void delay(unsigned long ms)
+{
+  (void)ms;
+}
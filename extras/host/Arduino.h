@@ -0,0 +1,68 @@
+/*
+MD_MAX72xx - Library for using a MAX7219/7221 LED matrix controller
+
+Arduino core stub for compiling and testing the library on a host computer.
+
+Only the parts of the Arduino core used by the library are defined. The
+digital outputs are simulated so that every frame of data sent to the
+devices (the bytes between the device select going LOW and HIGH) is
+recorded in hostFrames for the tests to check.
+
+Copyright (C) 2012-13 Marco Colli. All rights reserved.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <vector>
+#include "hostFrames.h"
+
+#ifndef ARDUINO
+#define ARDUINO 100
+#endif
+
+#define PROGMEM
+#define F(s) (s)
+
+#define LOW       0
+#define HIGH      1
+#define INPUT     0
+#define OUTPUT    1
+#define LSBFIRST  0
+#define MSBFIRST  1
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define pgm_read_byte(addr)  (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) (bitvalue ? bitSet(value, bit) : bitClear(value, bit))
+
+void pinMode(int8_t pin, uint8_t mode);
+void digitalWrite(int8_t pin, uint8_t value);
+void shiftOut(int8_t dataPin, int8_t clkPin, uint8_t order, uint8_t value);
+
+unsigned long micros(void);
+unsigned long millis(void);
+void delay(unsigned long ms);
@@ -0,0 +1,60 @@
+/*
+MD_MAX72xx - Library for using a MAX7219/7221 LED matrix controller
+
+Arduino SPI library stub for compiling and testing the library on a host
+computer. The bytes transferred are recorded in the current frame (see
+Arduino.h) and each beginTransaction() is counted.
+
+Copyright (C) 2012-13 Marco Colli. All rights reserved.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#pragma once
+
+#include "Arduino.h"
+
+#define SPI_MODE0 0
+
+class SPISettings
+{
+public:
+  SPISettings(void) {};
+  SPISettings(uint32_t clock, uint8_t order, uint8_t mode) { (void)clock; (void)order; (void)mode; };
+};
+
+class SPIClass
+{
+public:
+  void begin(void) {};
+  void end(void) {};
+  void beginTransaction(SPISettings settings) { (void)settings; hostTransactions++; };
+  void endTransaction(void) {};
+
+  uint8_t transfer(uint8_t value) { hostSendByte(value); return(0); };
+
+  // The received data overwrites the buffer, as it does on real hardware
+  void transfer(void *buf, size_t count)
+  {
+    uint8_t *p = (uint8_t *)buf;
+
+    for (size_t i = 0; i < count; i++)
+    {
+      hostSendByte(p[i]);
+      p[i] = 0xff;
+    }
+  };
+};
+
+extern SPIClass SPI;
@@ -0,0 +1,61 @@
+/*
+MD_MAX72xx - Library for using a MAX7219/7221 LED matrix controller
+
+Record of the data sent to the devices for the host computer build.
+
+Copyright (C) 2012-13 Marco Colli. All rights reserved.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include "hostFrames.h"
+
+std::vector<hostFrame_t> hostFrames;
+uint16_t hostTransactions = 0;
+
+static std::vector<uint8_t> frameData;  // bytes sent since the devices were selected
+static bool frameActive = false;        // the devices are selected
+
+void hostReset(void)
+{
+  hostFrames.clear();
+  hostTransactions = 0;
+  frameData.clear();
+  frameActive = false;
+}
+
+void hostFrameStart(void)
+{
+  frameData.clear();
+  frameActive = true;
+}
+
+void hostSendByte(uint8_t value)
+{
+  frameData.push_back(value);
+}
+
+void hostFrameEnd(int8_t cs)
+{
+  if (!frameActive)
+    return;
+
+  hostFrame_t f;
+
+  f.cs = cs;
+  f.transaction = hostTransactions;
+  f.data = frameData;
+  hostFrames.push_back(f);
+  frameActive = false;
+}
@@ -0,0 +1,47 @@
+/*
+MD_MAX72xx - Library for using a MAX7219/7221 LED matrix controller
+
+Record of the data sent to the devices for the host computer build.
+
+Each frame is the data sent between selecting the devices and latching the
+data into them, recorded by the Arduino stubs or by HostTransport.
+
+Copyright (C) 2012-13 Marco Colli. All rights reserved.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <vector>
+
+// One frame of data sent to the devices
+typedef struct
+{
+  int8_t   cs;          // device select pin used for the frame
+  uint16_t transaction; // SPI transaction number when the frame was sent
+  std::vector<uint8_t> data; // bytes in the order they were sent
+} hostFrame_t;
+
+extern std::vector<hostFrame_t> hostFrames; // all the frames sent since hostReset()
+extern uint16_t hostTransactions;           // number of SPI transactions since hostReset()
+
+void hostReset(void);                       // clear the recorded frames and counts
+void hostFrameStart(void);                  // the devices are selected
+void hostSendByte(uint8_t value);           // record a byte in the current frame
+void hostFrameEnd(int8_t cs);               // the data is latched, record the frame
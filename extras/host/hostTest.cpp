@@ -0,0 +1,179 @@
+/*
+MD_MAX72xx - Library for using a MAX7219/7221 LED matrix controller
+
+Unit test support and main program for the host computer build.
+
+Copyright (C) 2012-13 Marco Colli. All rights reserved.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include "hostTest.h"
+
+uint32_t testChecks = 0;
+uint32_t testFailures = 0;
+
+HostTransport hostTransport;
+
+void HostTransport::send(const uint8_t *data, uint16_t size)
+{
+  hostFrameStart();
+  for (uint16_t i = 0; i < size; i++)
+    hostSendByte(data[i]);
+  hostFrameEnd(_cs);
+}
+
+HostDevices::HostDevices(MD_MAX72XX::moduleType_t mod, uint8_t numDevices) :
+  _numDevices(numDevices), _csPins(1, CS_PIN), _lastDev(1, numDevices - 1),
+  _reg(numDevices, std::vector<uint8_t>(16, 0))
+{
+  uint8_t m;
+
+  // the named types are the same as one of the structured names
+  switch (mod)
+  {
+    case MD_MAX72XX::GENERIC_HW:   m = MD_MAX72XX::DR0CR1RR0_HW; break;
+    case MD_MAX72XX::FC16_HW:      m = MD_MAX72XX::DR1CR0RR0_HW; break;
+    case MD_MAX72XX::PAROLA_HW:    m = MD_MAX72XX::DR1CR1RR0_HW; break;
+    case MD_MAX72XX::ICSTATION_HW: m = MD_MAX72XX::DR1CR1RR1_HW; break;
+    default:                       m = mod; break;
+  }
+  m -= MD_MAX72XX::DR0CR0RR0_HW;
+  _digRows = (m & 4) != 0;
+  _revCols = (m & 2) != 0;
+  _revRows = (m & 1) != 0;
+
+  hostTransport.setChains(0, nullptr);
+}
+
+void HostDevices::setChains(uint8_t count, const int8_t *csPins, const uint8_t *devices)
+{
+  uint8_t last = 0;
+
+  hostTransport.setChains(count, csPins);
+  _csPins.clear();
+  _lastDev.clear();
+  for (uint8_t k = 0; k < count; k++)
+  {
+    last += devices[k];
+    _csPins.push_back(csPins[k]);
+    _lastDev.push_back(last - 1);
+  }
+}
+
+bool HostDevices::apply(void)
+// The first data pair in a frame is shifted through to the last device in the chain
+{
+  bool ok = true;
+
+  for (size_t i = 0; i < hostFrames.size(); i++)
+  {
+    const hostFrame_t &f = hostFrames[i];
+    uint8_t k = 0;
+
+    while ((k < _csPins.size()) && (_csPins[k] != f.cs))
+      k++;
+    if (k == _csPins.size())
+    {
+      ok = false;
+      continue;
+    }
+
+    const uint8_t first = (k == 0) ? 0 : _lastDev[k - 1] + 1;
+
+    if (f.data.size() != (size_t)(_lastDev[k] - first + 1) * 2)
+    {
+      ok = false;
+      continue;
+    }
+    for (size_t j = 0; j < f.data.size(); j += 2)
+    {
+      const uint8_t dev = _lastDev[k] - (j / 2);
+      const uint8_t addr = f.data[j] & 0xf;
+
+      if (addr != 0)  // not a no-op
+        _reg[dev][addr] = f.data[j + 1];
+    }
+  }
+  hostFrames.clear();
+
+  return(ok);
+}
+
+bool HostDevices::pixel(uint8_t r, uint16_t c)
+{
+  const uint8_t dev = c / 8;
+  uint8_t bit;
+
+  c %= 8;
+  if (_digRows)
+    bit = _revCols ? 7 - c : c;
+  else
+    bit = _revCols ? 7 - r : r;
+
+  return(((_reg[dev][1 + digit(r, c)] >> bit) & 1) != 0);
+}
+
+uint8_t HostDevices::digit(uint8_t r, uint16_t c)
+{
+  c %= 8;
+  if (_digRows)
+    return(_revRows ? 7 - r : r);
+  else
+    return(_revRows ? 7 - c : c);
+}
+
+uint32_t testRandom(void)
+{
+  static uint32_t seed = 1;
+
+  seed = (seed * 1103515245) + 12345;
+
+  return(seed >> 16);
+}
+
+hostPixels_t readPixels(MD_MAX72XX &mx)
+{
+  hostPixels_t p(ROW_SIZE, std::vector<bool>(mx.getColumnCount()));
+
+  for (uint8_t r = 0; r < ROW_SIZE; r++)
+    for (uint16_t c = 0; c < mx.getColumnCount(); c++)
+      p[r][c] = mx.getPoint(r, c);
+
+  return(p);
+}
+
+bool showsPixels(MD_MAX72XX &mx, HostDevices &hd, const hostPixels_t &p)
+{
+  for (uint8_t r = 0; r < ROW_SIZE; r++)
+    for (uint16_t c = 0; c < mx.getColumnCount(); c++)
+      if ((mx.getPoint(r, c) != p[r][c]) || (hd.pixel(r, c) != p[r][c]))
+        return(false);
+
+  return(true);
+}
+
+int main(void)
+{
+  testUpdate();
+  testTransform();
+  testFont();
+  testGfx();
+  testTile();
+  testTemplate();
+
+  printf("%s: %u checks, %u failed\n", MD_MAX72XX_BUILD, testChecks, testFailures);
+
+  return(testFailures == 0 ? 0 : 1);
+}
@@ -0,0 +1,120 @@
+/*
+MD_MAX72xx - Library for using a MAX7219/7221 LED matrix controller
+
+Unit test support for the host computer build.
+
+HostDevices simulates the chains of MAX72xx devices, replaying the frames
+recorded by the Arduino stubs into the device registers, so that the tests
+can check what is actually displayed against what the library reports.
+
+Copyright (C) 2012-13 Marco Colli. All rights reserved.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#pragma once
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <SPI.h>
+#endif
+#include "hostFrames.h"
+#include "MD_MAX72xx.h"
+
+extern uint32_t testChecks;   // number of checks made
+extern uint32_t testFailures; // number of checks failed
+
+// Count a check and report it if the condition is false
+#define CHECK(cond) \
+  do { testChecks++; if (!(cond)) { testFailures++; printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); } } while (false)
+
+// Report a check with the values compared if they are not equal
+#define CHECK_EQ(a, b) \
+  do { testChecks++; long _a = (long)(a), _b = (long)(b); \
+    if (_a != _b) { testFailures++; printf("%s:%d: CHECK_EQ(%s, %s) failed: %ld != %ld\n", __FILE__, __LINE__, #a, #b, _a, _b); } } while (false)
+
+const int8_t CS_PIN = 10;     // device select for a single chain
+
+// Communications that record the frames in the same way as the Arduino stubs.
+// Messages for chain k are recorded with the device select set by setChains().
+class HostTransport : public MD_MAX72XX_Transport
+{
+public:
+  HostTransport(void) : _cs(CS_PIN) {};
+
+  void setChains(uint8_t count, const int8_t *csPins) { _csPins.assign(csPins, csPins + count); _cs = CS_PIN; };
+
+  virtual void beginTransaction(void) { hostTransactions++; };
+  virtual void selectChain(uint8_t chain) { _cs = (chain < _csPins.size()) ? _csPins[chain] : CS_PIN; };
+  virtual void send(const uint8_t *data, uint16_t size);
+
+private:
+  int8_t _cs;                   // device select for the next message
+  std::vector<int8_t> _csPins;  // device select for each chain
+};
+
+extern HostTransport hostTransport;
+
+// The communications passed to the library constructors. Without ARDUINO only
+// the transport constructor is available.
+#ifdef ARDUINO
+#define HOST_COMMS  CS_PIN
+#else
+#define HOST_COMMS  hostTransport
+#endif
+
+class HostDevices
+{
+public:
+  HostDevices(MD_MAX72XX::moduleType_t mod, uint8_t numDevices);
+
+  // Split the devices into chains, as MD_MAX72XX::setChains(). The chain
+  // outputs are also set in hostTransport, which the constructor resets.
+  void setChains(uint8_t count, const int8_t *csPins, const uint8_t *devices);
+
+  // Replay the recorded frames into the devices and clear the record.
+  // Returns false if a frame is not the right size for its chain.
+  bool apply(void);
+
+  uint8_t reg(uint8_t dev, uint8_t addr) { return(_reg[dev][addr & 0xf]); };
+  bool pixel(uint8_t r, uint16_t c);  // display pixel, decoded for the module type
+  uint8_t digit(uint8_t r, uint16_t c); // device digit [0..7] that holds the display pixel
+  bool digRows(void) { return(_digRows); }; // the device digits are display rows
+
+private:
+  uint8_t _numDevices;
+  bool    _digRows, _revCols, _revRows;
+  std::vector<int8_t>  _csPins;       // device select for each chain
+  std::vector<uint8_t> _lastDev;      // last device in each chain
+  std::vector<std::vector<uint8_t> > _reg; // 16 registers for each device
+};
+
+// Random number generator for the tests, repeatable on any host
+uint32_t testRandom(void);
+
+// Model of the display pixels, indexed [row][column] as for getPoint()
+typedef std::vector<std::vector<bool> > hostPixels_t;
+
+hostPixels_t readPixels(MD_MAX72XX &mx);  // the pixels in the library buffers
+
+// The library buffers and the devices both show the model pixels
+bool showsPixels(MD_MAX72XX &mx, HostDevices &hd, const hostPixels_t &p);
+
+// Tests for each part of the library
+void testUpdate(void);
+void testTransform(void);
+void testFont(void);
+void testGfx(void);
+void testTile(void);
+void testTemplate(void);
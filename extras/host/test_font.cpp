@@ -0,0 +1,387 @@
+/*
+MD_MAX72xx - Library for using a MAX7219/7221 LED matrix controller
+
+Unit tests for the font handling: the font table versions, reading the
+characters from font tables and font sources, and the font cache.
+
+Copyright (C) 2012-13 Marco Colli. All rights reserved.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <map>
+#include "hostTest.h"
+
+typedef std::map<uint16_t, std::vector<uint8_t> > chars_t;  // column data for each character code
+
+static void randomChars(chars_t &chars, uint16_t first, uint16_t last)
+// Add characters [first..last] with random column data, some with no columns
+{
+  for (uint32_t c = first; c <= last; c++)
+  {
+    std::vector<uint8_t> &d = chars[c];
+    const uint8_t width = (testRandom() % 5 == 0) ? 0 : 1 + (testRandom() % 8);
+
+    d.clear();
+    for (uint8_t i = 0; i < width; i++)
+      d.push_back(testRandom());
+  }
+}
+
+static void addChar(std::vector<uint8_t> &t, const chars_t &chars, uint16_t c)
+{
+  chars_t::const_iterator it = chars.find(c);
+
+  if (it == chars.end())
+    t.push_back(0);
+  else
+  {
+    t.push_back(it->second.size());
+    t.insert(t.end(), it->second.begin(), it->second.end());
+  }
+}
+
+static std::vector<uint8_t> encode(uint8_t version, const chars_t &chars)
+// Make the font table with the characters in the format for the version
+{
+  std::vector<uint8_t> t;
+  const uint16_t first = chars.begin()->first;
+  const uint16_t last = chars.rbegin()->first;
+
+  if (version == 3)
+  {
+    std::vector<uint16_t> codes;  // directory order
+    std::vector<uint8_t> data;
+
+    t.push_back('F');
+    t.push_back(3);
+    t.push_back(8);
+    t.push_back(0);
+    t.push_back(0);   // number of ranges set below
+    for (chars_t::const_iterator it = chars.begin(); it != chars.end(); )
+    {
+      uint16_t end = it->first;
+
+      while ((chars.find(end + 1) != chars.end()) && (end != 0xffff))
+        end++;
+      t.push_back(it->first >> 8);
+      t.push_back(it->first & 0xff);
+      t.push_back(end >> 8);
+      t.push_back(end & 0xff);
+      t.push_back(codes.size() >> 8);
+      t.push_back(codes.size() & 0xff);
+      for (uint32_t c = it->first; c <= end; c++)
+        codes.push_back(c);
+      it = chars.upper_bound(end);
+      t[4]++;
+    }
+    for (size_t i = 0; i < codes.size(); i++)
+    {
+      t.push_back(data.size() >> 8);
+      t.push_back(data.size() & 0xff);
+      addChar(data, chars, codes[i]);
+    }
+    t.insert(t.end(), data.begin(), data.end());
+  }
+  else
+  {
+    t.push_back('F');
+    t.push_back(version);
+    if (version == 2)
+    {
+      t.push_back(first >> 8);
+      t.push_back(first & 0xff);
+      t.push_back(last >> 8);
+      t.push_back(last & 0xff);
+    }
+    else
+    {
+      t.push_back(first);
+      t.push_back(last);
+    }
+    t.push_back(8);
+    for (uint32_t c = first; c <= last; c++)
+      addChar(t, chars, c);
+  }
+
+  return(t);
+}
+
+static bool checkChars(MD_MAX72XX &mx, const chars_t &chars, uint32_t lo, uint32_t hi)
+// The characters [lo..hi] read from the current font match the table
+{
+  bool ok = true;
+  uint8_t buf[16];
+
+  for (uint32_t c = lo; c <= hi; c++)
+  {
+    chars_t::const_iterator it = chars.find(c);
+    const uint8_t width = mx.getChar(c, sizeof(buf), buf);
+
+    if (it == chars.end())
+      ok = ok && (width == 0) && (mx.getCharWidth(c) == 0);
+    else
+    {
+      ok = ok && (width == it->second.size()) && (mx.getCharWidth(c) == width);
+      ok = ok && ((width == 0) || (memcmp(buf, it->second.data(), width) == 0));
+    }
+  }
+
+  return(ok);
+}
+
+static void checkInfo(MD_MAX72XX &mx, uint8_t version, const chars_t &chars)
+{
+  const MD_MAX72XX::fontInfo_t &fi = mx.getFontInfo();
+  uint8_t widthMax = 0;
+  uint16_t count = 0;
+
+  for (chars_t::const_iterator it = chars.begin(); it != chars.end(); it++)
+  {
+    if (it->second.size() > widthMax) widthMax = it->second.size();
+    if (it->second.size() != 0) count++;
+  }
+
+  CHECK_EQ(fi.version, version);
+  CHECK_EQ(fi.height, 8);
+  CHECK_EQ(fi.firstASCII, chars.begin()->first);
+  CHECK_EQ(fi.lastASCII, chars.rbegin()->first);
+  CHECK_EQ(fi.widthMax, widthMax);
+  CHECK_EQ(fi.charCount, count);
+  CHECK((fi.flags & MD_MAX72XX::FONT_UNKNOWN_VER) == 0);
+}
+
+// File class with the methods used by MD_MAX72XX_FileFont
+class HostFile
+{
+public:
+  HostFile(const std::vector<uint8_t> &data) : reads(0)
+  {
+    _fp = tmpfile();
+    fwrite(data.data(), 1, data.size(), _fp);
+  };
+  ~HostFile(void) { fclose(_fp); };
+
+  bool seek(uint32_t pos) { return(fseek(_fp, pos, SEEK_SET) == 0); };
+  int read(uint8_t *buf, size_t size) { reads++; return(fread(buf, 1, size, _fp)); };
+
+  uint32_t reads; // number of reads from the file
+
+private:
+  FILE *_fp;
+};
+
+static void testVersions(void)
+{
+  MD_MAX72XX mx(MD_MAX72XX::FC16_HW, HOST_COMMS, 1);
+  chars_t ascii, wide, sparse;
+
+  mx.begin();
+  CHECK_EQ(mx.getFontInfo().firstASCII, 0);  // system font
+  CHECK_EQ(mx.getFontInfo().lastASCII, 255);
+
+  randomChars(ascii, ' ', '~');
+  randomChars(wide, 0x390, 0x3ff);
+  randomChars(sparse, ' ', '~');
+  randomChars(sparse, 0x2190, 0x21ff);
+  randomChars(sparse, 0xfff0, 0xffff);
+
+  const std::vector<uint8_t> v1 = encode(1, ascii);
+  const std::vector<uint8_t> v2 = encode(2, wide);
+  const std::vector<uint8_t> v3 = encode(3, sparse);
+
+  mx.setFont(v1.data());
+  checkInfo(mx, 1, ascii);
+  CHECK_EQ(mx.getFontInfo().dataSize, v1.size());
+  CHECK(checkChars(mx, ascii, 0, 0x1ff));
+
+  mx.setFont(v2.data());
+  checkInfo(mx, 2, wide);
+  CHECK(checkChars(mx, wide, 0x300, 0x4ff));
+
+  mx.setFont(v3.data());
+  checkInfo(mx, 3, sparse);
+  CHECK_EQ(mx.getFontInfo().rangeCount, 3);
+  CHECK_EQ(mx.getFontInfo().dataSize, v3.size());
+  CHECK(checkChars(mx, sparse, 0, 0xffff));
+
+  // more fonts than FONT_CACHE_SIZE, used again
+  mx.setFont(v1.data());
+  CHECK(checkChars(mx, ascii, ' ', '~'));
+  mx.setFont(nullptr);
+  CHECK_EQ(mx.getFontInfo().lastASCII, 255);
+  mx.setFont(v2.data());
+  CHECK(checkChars(mx, wide, 0x390, 0x3ff));
+}
+
+static void testSources(void)
+{
+  MD_MAX72XX mx(MD_MAX72XX::FC16_HW, HOST_COMMS, 1);
+  chars_t wide, sparse;
+
+  mx.begin();
+  randomChars(wide, 0x20, 0x7ff);
+  randomChars(sparse, 0x20, 0x7e);
+  randomChars(sparse, 0x4e00, 0x4fff);
+
+  const std::vector<uint8_t> v2 = encode(2, wide);
+  const std::vector<uint8_t> v3 = encode(3, sparse);
+  MD_MAX72XX_MemFont mem2(v2.data(), v2.size());
+  MD_MAX72XX_MemFont mem3(v3.data(), v3.size());
+  HostFile file2(v2), file3(v3);
+  MD_MAX72XX_FileFont<HostFile> ff2(file2), ff3(file3);
+
+  CHECK(mx.setFontSource(&mem2));
+  CHECK(mx.getFontSource() == &mem2);
+  CHECK(mx.getFont() == nullptr);
+  checkInfo(mx, 2, wide);
+  CHECK(checkChars(mx, wide, 0, 0x8ff));
+
+  CHECK(mx.setFontSource(&ff2));
+  checkInfo(mx, 2, wide);
+  CHECK(checkChars(mx, wide, 0, 0x8ff));
+
+  // the last character is found without reading the whole file
+  uint8_t buf[16];
+
+  file2.reads = 0;
+  mx.getChar(0x7ff, sizeof(buf), buf);
+  CHECK(file2.reads < 10);
+
+  CHECK(mx.setFontSource(&mem3));
+  checkInfo(mx, 3, sparse);
+  CHECK(checkChars(mx, sparse, 0, 0xffff));
+
+  CHECK(mx.setFontSource(&ff3));
+  checkInfo(mx, 3, sparse);
+  CHECK(checkChars(mx, sparse, 0x4d00, 0x50ff));
+
+  CHECK(mx.setFontSource(nullptr));
+  CHECK(mx.getFontSource() == nullptr);
+  CHECK_EQ(mx.getFontInfo().lastASCII, 255);
+}
+
+static void testLargeSource(void)
+// A version 2 font too large for the full index. The offset index is limited to
+// FONT_SOURCE_INDEX_MAX entries, so the reads to find any character are bounded.
+{
+  MD_MAX72XX mx(MD_MAX72XX::FC16_HW, HOST_COMMS, 1);
+  chars_t wide;
+
+  mx.begin();
+  randomChars(wide, 0x20, 0x3fff);
+
+  const std::vector<uint8_t> v2 = encode(2, wide);
+  const uint32_t count = wide.size();
+  uint32_t step = (count + FONT_SOURCE_INDEX_MAX - 1) / FONT_SOURCE_INDEX_MAX;
+  HostFile file(v2);
+  MD_MAX72XX_FileFont<HostFile> ff(file);
+  FILE *fp = tmpfile();
+
+  if (step < FONT_SOURCE_STEP) step = FONT_SOURCE_STEP;
+  fwrite(v2.data(), 1, v2.size(), fp);
+  MD_MAX72XX_StdioFont sf(fp);
+
+  CHECK(v2.size() > UINT16_MAX);
+  CHECK(mx.setFontSource(&sf));
+  checkInfo(mx, 2, wide);
+  CHECK_EQ(mx.getFontInfo().dataSize, v2.size());
+  for (uint32_t c = 0x20; c <= 0x3fff; c += 37)
+    CHECK(checkChars(mx, wide, c, c));
+  CHECK(checkChars(mx, wide, 0x3ff0, 0x4010));
+
+  // each search reads at most the characters from the nearest index entry
+  const uint32_t limit = 2 + ((step * (mx.getMaxFontWidth() + 1)) / FONT_READ_AHEAD);
+  uint32_t most = 0;
+  uint8_t buf[16];
+
+  CHECK(mx.setFontSource(&ff));
+  for (uint32_t c = 0x20; c <= 0x3fff; c += 101)
+  {
+    file.reads = 0;
+    mx.getChar(c, sizeof(buf), buf);
+    if (file.reads > most) most = file.reads;
+  }
+  CHECK(most <= limit);
+
+  mx.setFontSource(nullptr);
+  fclose(fp);
+}
+
+static void testClearCache(void)
+// New font data at the same address is only seen after clearFontCache()
+{
+  MD_MAX72XX mx(MD_MAX72XX::FC16_HW, HOST_COMMS, 1);
+  chars_t ascii, changed;
+
+  mx.begin();
+  randomChars(ascii, ' ', '~');
+  ascii['A'].assign(2, 0x0f);
+  changed = ascii;
+  changed['A'].assign(8, 0xf0);
+  changed['~'].clear();
+
+  const std::vector<uint8_t> v1 = encode(1, ascii);
+  const std::vector<uint8_t> v1Changed = encode(1, changed);
+  std::vector<uint8_t> font(v1.size() > v1Changed.size() ? v1.size() : v1Changed.size());
+  MD_MAX72XX_MemFont mem(font.data(), font.size());
+  uint8_t buf[16];
+
+  memcpy(font.data(), v1.data(), v1.size());
+  mx.setFont(font.data());
+  CHECK_EQ(mx.getChar('A', sizeof(buf), buf), 2);
+
+  memcpy(font.data(), v1Changed.data(), v1Changed.size());
+  mx.setFont(font.data());
+  mx.clearFontCache();
+  checkInfo(mx, 1, changed);
+  CHECK(checkChars(mx, changed, ' ', '~'));
+
+  // the same for a font source
+  memcpy(font.data(), v1.data(), v1.size());
+  mx.setFontSource(&mem);
+  CHECK_EQ(mx.getChar('A', sizeof(buf), buf), 2);
+  memcpy(font.data(), v1Changed.data(), v1Changed.size());
+  mx.clearFontCache();
+  CHECK(mx.getFontSource() == &mem);
+  checkInfo(mx, 1, changed);
+  CHECK(checkChars(mx, changed, ' ', '~'));
+}
+
+static void testText(void)
+{
+  MD_MAX72XX mx(MD_MAX72XX::FC16_HW, HOST_COMMS, 1);
+  chars_t ascii;
+
+  mx.begin();
+  randomChars(ascii, ' ', '~');
+  ascii['A'].assign(3, 0xff);
+  ascii['B'].assign(5, 0x81);
+
+  const std::vector<uint8_t> v1 = encode(1, ascii);
+
+  mx.setFont(v1.data());
+  CHECK_EQ(mx.getTextWidth("AB"), 3 + 1 + 5);
+  mx.setTextSpacing(2);
+  CHECK_EQ(mx.getTextWidth("ABA"), 3 + 2 + 5 + 2 + 3);
+}
+
+void testFont(void)
+{
+  testVersions();
+  testSources();
+  testLargeSource();
+  testClearCache();
+  testText();
+}
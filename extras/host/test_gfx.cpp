@@ -0,0 +1,428 @@
+/*
+MD_MAX72xx - Library for using a MAX7219/7221 LED matrix controller
+
+Unit tests for the graphics drawing methods. The result of each drawing is
+compared to a simple model of the display pixels, both in the library
+buffers and as sent to the devices.
+
+Copyright (C) 2012-13 Marco Colli. All rights reserved.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <algorithm>
+#include "hostTest.h"
+
+const uint8_t DEVICES = 4;
+const uint16_t COLS = DEVICES * COL_SIZE;
+
+static uint16_t countPoints(MD_MAX72XX &mx)
+{
+  uint16_t n = 0;
+
+  for (uint8_t r = 0; r < ROW_SIZE; r++)
+    for (uint16_t c = 0; c < COLS; c++)
+      if (mx.getPoint(r, c)) n++;
+
+  return(n);
+}
+
+static void blitModel(hostPixels_t &p, int16_t x, int8_t y, uint8_t w, uint8_t h, const uint8_t *bitmap, MD_MAX72XX::rasterOp_t rop)
+// Bitmap column i is display column x-i and bit j is display row y+j
+{
+  for (uint8_t i = 0; i < w; i++)
+  {
+    for (uint8_t j = 0; j < h; j++)
+    {
+      const int16_t c = x - i;
+      const int16_t r = y + j;
+
+      if ((c < 0) || (c >= COLS) || (r < 0) || (r >= ROW_SIZE))
+        continue;
+
+      const bool b = ((bitmap[i] >> j) & 1) != 0;
+
+      switch (rop)
+      {
+        case MD_MAX72XX::ROP_COPY: p[r][c] = b; break;
+        case MD_MAX72XX::ROP_OR:   p[r][c] = p[r][c] || b; break;
+        case MD_MAX72XX::ROP_AND:  p[r][c] = p[r][c] && b; break;
+        case MD_MAX72XX::ROP_XOR:  p[r][c] = p[r][c] != b; break;
+      }
+    }
+  }
+}
+
+static void testBlit(MD_MAX72XX::moduleType_t mod)
+{
+  MD_MAX72XX mx(mod, HOST_COMMS, DEVICES);
+  HostDevices hd(mod, DEVICES);
+  uint8_t bitmap[24];
+
+  hostReset();
+  mx.begin();
+  hd.apply();
+
+  hostPixels_t p = readPixels(mx);
+
+  for (uint8_t n = 0; n < 100; n++)
+  {
+    const int16_t x = (int16_t)(testRandom() % (COLS + 40)) - 20;
+    const int8_t y = (int8_t)(testRandom() % (2 * ROW_SIZE + 3)) - ROW_SIZE - 1;
+    const uint8_t w = testRandom() % sizeof(bitmap);
+    const uint8_t h = 1 + (testRandom() % ROW_SIZE);
+    const MD_MAX72XX::rasterOp_t rop = (MD_MAX72XX::rasterOp_t)(testRandom() % 4);
+
+    for (uint8_t i = 0; i < sizeof(bitmap); i++)
+      bitmap[i] = testRandom();
+
+    CHECK(mx.blit(x, y, w, h, bitmap, rop));
+    CHECK(hostFrames.size() <= ROW_SIZE);   // sent once
+    CHECK(hd.apply());
+    blitModel(p, x, y, w, h, bitmap, rop);
+
+    const bool ok = showsPixels(mx, hd, p);
+
+    CHECK(ok);
+    if (!ok)
+      printf("  module %d blit (%d, %d) %dx%d rop %d\n", mod, x, y, w, h, rop);
+  }
+
+  // parameter errors do not change the display
+  CHECK(!mx.blit(0, 0, 4, 0, bitmap));
+  CHECK(!mx.blit(0, 0, 4, ROW_SIZE + 1, bitmap));
+  CHECK(!mx.blit(0, 0, 4, 4, nullptr));
+  CHECK(!mx.blit(0, 0, 4, 4, bitmap, (MD_MAX72XX::rasterOp_t)(MD_MAX72XX::ROP_XOR + 1)));
+  CHECK(hostFrames.empty());
+  CHECK(showsPixels(mx, hd, p));
+}
+
+static void setModel(hostPixels_t &p, int32_t r, int32_t c, bool state)
+{
+  if ((r >= 0) && (r < ROW_SIZE) && (c >= 0) && (c < COLS))
+    p[r][c] = state;
+}
+
+static void lineModel(hostPixels_t &p, int32_t r1, int32_t c1, int32_t r2, int32_t c2, bool state)
+// Bresenham's line algorithm, from the end with the lower column
+{
+  if (c1 > c2)
+  {
+    int32_t t = c1; c1 = c2; c2 = t;
+    t = r1; r1 = r2; r2 = t;
+  }
+
+  const int32_t dc = c2 - c1;
+  const int32_t dr = -abs(r2 - r1);
+  const int32_t sr = (r1 < r2) ? 1 : -1;
+  int32_t err = dc + dr;
+
+  while (true)
+  {
+    setModel(p, r1, c1, state);
+    if ((c1 == c2) && (r1 == r2))
+      break;
+
+    const int32_t e2 = 2 * err;
+
+    if (e2 >= dr) { err += dr; c1++; }
+    if (e2 <= dc) { err += dc; r1 += sr; }
+  }
+}
+
+static void rectModel(hostPixels_t &p, int32_t r1, int32_t c1, int32_t r2, int32_t c2, bool state, bool fill)
+{
+  for (int32_t r = std::min(r1, r2); r <= std::max(r1, r2); r++)
+    for (int32_t c = std::min(c1, c2); c <= std::max(c1, c2); c++)
+      if (fill || (r == r1) || (r == r2) || (c == c1) || (c == c2))
+        setModel(p, r, c, state);
+}
+
+static void circleModel(hostPixels_t &p, int32_t r, int32_t c, int32_t radius, bool state, bool fill)
+// The points of the midpoint circle algorithm, or the rows between them when filled
+{
+  std::vector<int32_t> rowMin(ROW_SIZE, INT32_MAX), rowMax(ROW_SIZE, INT32_MIN);
+  int32_t x = radius, y = 0;
+  int32_t err = 1 - x;
+
+  while (x >= y)
+  {
+    const int32_t pts[8][2] = 
+    { 
+      { r + y, c + x }, { r + y, c - x }, { r - y, c + x }, { r - y, c - x },
+      { r + x, c + y }, { r + x, c - y }, { r - x, c + y }, { r - x, c - y } 
+    };
+
+    for (uint8_t i = 0; i < 8; i++)
+    {
+      if (!fill)
+        setModel(p, pts[i][0], pts[i][1], state);
+      else if ((pts[i][0] >= 0) && (pts[i][0] < ROW_SIZE))
+      {
+        rowMin[pts[i][0]] = std::min(rowMin[pts[i][0]], pts[i][1]);
+        rowMax[pts[i][0]] = std::max(rowMax[pts[i][0]], pts[i][1]);
+      }
+    }
+
+    y++;
+    if (err < 0)
+      err += 2 * y + 1;
+    else
+    {
+      x--;
+      err += 2 * (y - x) + 1;
+    }
+  }
+
+  if (fill)
+    for (uint8_t i = 0; i < ROW_SIZE; i++)
+      for (int32_t k = rowMin[i]; k <= rowMax[i]; k++)
+        setModel(p, i, k, state);
+}
+
+static void fillModel(hostPixels_t &p, uint8_t r, uint16_t c, bool state)
+// Every pixel connected to (r, c) through pixels in the other state
+{
+  std::vector<std::pair<int32_t, int32_t> > todo;
+
+  if (p[r][c] == state)
+    return;
+
+  todo.push_back(std::make_pair(r, c));
+  p[r][c] = state;
+  while (!todo.empty())
+  {
+    const int32_t pr = todo.back().first;
+    const int32_t pc = todo.back().second;
+    const int32_t next[4][2] = { { pr - 1, pc }, { pr + 1, pc }, { pr, pc - 1 }, { pr, pc + 1 } };
+
+    todo.pop_back();
+    for (uint8_t i = 0; i < 4; i++)
+    {
+      const int32_t nr = next[i][0], nc = next[i][1];
+
+      if ((nr >= 0) && (nr < ROW_SIZE) && (nc >= 0) && (nc < COLS) && (p[nr][nc] != state))
+      {
+        p[nr][nc] = state;
+        todo.push_back(std::make_pair(nr, nc));
+      }
+    }
+  }
+}
+
+static void testShapes(MD_MAX72XX::moduleType_t mod)
+{
+  static const char *names[] = { "drawLine", "drawRect", "fillRect", "drawCircle", "fillCircle", "floodFill" };
+  MD_MAX72XX mx(mod, HOST_COMMS, DEVICES);
+  HostDevices hd(mod, DEVICES);
+
+  hostReset();
+  mx.begin();
+  hd.apply();
+
+  hostPixels_t p = readPixels(mx);
+
+  for (uint16_t n = 0; n < 300; n++)
+  {
+    const uint8_t shape = testRandom() % 6;
+    const int8_t r1 = (int8_t)(testRandom() % (ROW_SIZE + 6)) - 3;
+    const int8_t r2 = (int8_t)(testRandom() % (ROW_SIZE + 6)) - 3;
+    const int16_t c1 = (int16_t)(testRandom() % (COLS + 40)) - 20;
+    const int16_t c2 = (int16_t)(testRandom() % (COLS + 40)) - 20;
+    const uint8_t radius = testRandom() % 12;
+    const bool state = (testRandom() % 3) != 0;
+
+    // random dots give flood fill some edges to find
+    if (shape == 5)
+    {
+      for (uint16_t i = 0; i < COLS; i++)
+      {
+        const uint8_t r = testRandom() % ROW_SIZE;
+
+        mx.setPoint(r, i, state);
+        p[r][i] = state;
+      }
+      hd.apply();
+    }
+
+    switch (shape)
+    {
+      case 0: mx.drawLine(r1, c1, r2, c2, state); lineModel(p, r1, c1, r2, c2, state); break;
+      case 1: mx.drawRect(r1, c1, r2, c2, state); rectModel(p, r1, c1, r2, c2, state, false); break;
+      case 2: mx.fillRect(r1, c1, r2, c2, state); rectModel(p, r1, c1, r2, c2, state, true); break;
+      case 3: mx.drawCircle(r1, c1, radius, state); circleModel(p, r1, c1, radius, state, false); break;
+      case 4: mx.fillCircle(r1, c1, radius, state); circleModel(p, r1, c1, radius, state, true); break;
+      case 5:
+        {
+          const uint8_t r = testRandom() % ROW_SIZE;
+          const uint16_t c = testRandom() % COLS;
+
+          CHECK(mx.floodFill(r, c, state));
+          fillModel(p, r, c, state);
+        }
+        break;
+    }
+    CHECK(hostFrames.size() <= ROW_SIZE);   // sent once
+    CHECK(hd.apply());
+
+    const bool ok = showsPixels(mx, hd, p);
+
+    CHECK(ok);
+    if (!ok)
+      printf("  module %d %s (%d, %d) (%d, %d) radius %d state %d\n", mod, names[shape], r1, c1, r2, c2, radius, state);
+  }
+
+  CHECK(!mx.floodFill(ROW_SIZE, 0, true));
+  CHECK(!mx.floodFill(0, COLS, true));
+}
+
+static void canvasModel(hostPixels_t &p, const std::vector<uint8_t> &canvas, uint16_t colStart, uint16_t colEnd, int16_t offset, bool wrap)
+// Canvas column offset+k is shown in window column colEnd-k, repeating the
+// canvas with wraparound and off outside the canvas otherwise
+{
+  const int32_t width = canvas.size();
+
+  for (uint16_t c = colStart; c <= colEnd; c++)
+  {
+    int32_t i = offset + (colEnd - c);
+    uint8_t data = 0;
+
+    if (wrap)
+      i = ((i % width) + width) % width;
+    if ((i >= 0) && (i < width))
+      data = canvas[i];
+    for (uint8_t r = 0; r < ROW_SIZE; r++)
+      p[r][c] = ((data >> r) & 1) != 0;
+  }
+}
+
+static void testCanvas(MD_MAX72XX::moduleType_t mod)
+{
+  static const uint16_t widths[] = { 1, 5, COLS, 100 };
+  MD_MAX72XX mx(mod, HOST_COMMS, DEVICES);
+  HostDevices hd(mod, DEVICES);
+  uint16_t colStart = 0, colEnd = COLS - 1;   // the default window
+
+  hostReset();
+  mx.begin();
+  hd.apply();
+
+  CHECK(!mx.setViewport(0));        // no canvas
+  CHECK(!mx.setCanvasWindow(5, 4));
+  CHECK(!mx.setCanvasWindow(0, COLS));
+
+  for (uint8_t n = 0; n < 40; n++)
+  {
+    std::vector<uint8_t> canvas(widths[n % 4]);
+
+    for (uint16_t i = 0; i < canvas.size(); i++)
+      canvas[i] = testRandom();
+    CHECK(!mx.setCanvas(canvas.data(), 0));
+    CHECK(mx.setCanvas(canvas.data(), canvas.size(), (n & 1) != 0));
+    CHECK_EQ(mx.getViewport(), 0);
+
+    // a random window after the first few rounds, across the devices or in one device
+    if (n >= 4)
+    {
+      colStart = testRandom() % COLS;
+      colEnd = colStart + (testRandom() % (COLS - colStart));
+      if (n % 3 == 0)
+        colEnd = std::min<uint16_t>(colEnd, colStart | (COL_SIZE - 1));
+      CHECK(mx.setCanvasWindow(colStart, colEnd));
+    }
+
+    // the columns outside the window keep what is already drawn
+    for (uint16_t c = 0; c < COLS; c++)
+      mx.setColumn(c, testRandom());
+    hd.apply();
+
+    hostPixels_t p = readPixels(mx);
+
+    for (uint8_t step = 0; step < 6; step++)
+    {
+      const bool wrap = ((n + step) & 2) != 0;
+      const int16_t offset = (int16_t)(testRandom() % (4 * canvas.size() + 80)) - (2 * canvas.size() + 40);
+
+      mx.control(MD_MAX72XX::WRAPAROUND, wrap ? MD_MAX72XX::ON : MD_MAX72XX::OFF);
+      CHECK(mx.setViewport(offset));
+      CHECK_EQ(mx.getViewport(), offset);
+      canvasModel(p, canvas, colStart, colEnd, offset, wrap);
+      CHECK(hostFrames.size() <= ROW_SIZE);   // sent once
+      CHECK(hd.apply());
+
+      const bool ok = showsPixels(mx, hd, p);
+
+      CHECK(ok);
+      if (!ok)
+        printf("  module %d canvas width %u window %u-%u offset %d wrap %d\n", mod, (unsigned)canvas.size(), colStart, colEnd, offset, wrap);
+
+      // nothing has changed to send
+      CHECK(mx.setViewport(offset));
+      CHECK(hostFrames.empty());
+    }
+  }
+
+  CHECK(mx.setCanvas(nullptr, 0));
+  CHECK(!mx.setViewport(0));
+}
+
+static void testEdges(void)
+// Shapes at the ends of the column range must finish and only draw on the display
+{
+  MD_MAX72XX mx(MD_MAX72XX::FC16_HW, HOST_COMMS, DEVICES);
+
+  hostReset();
+  mx.begin();
+
+  mx.fillRect(0, 32760, 7, 32767);
+  mx.drawRect(0, 32700, 7, 32767);
+  mx.drawCircle(3, 32767, 5);
+  mx.fillCircle(3, 32767, 255);
+  mx.fillRect(0, -32768, 7, -32760);
+  mx.drawCircle(3, -32768, 5);
+  mx.fillCircle(3, -32768, 255);
+  CHECK_EQ(countPoints(mx), 0);
+
+  // a rectangle across the whole column range only has its top and bottom on the display
+  mx.drawRect(0, -32768, 7, 32767);
+  CHECK_EQ(countPoints(mx), 2 * COLS);
+  mx.fillRect(0, 32767, 7, -32768);
+  CHECK_EQ(countPoints(mx), ROW_SIZE * COLS);
+  mx.clear();
+
+  // the part of a circle on the display is the same wherever the center is
+  mx.fillCircle(3, COLS + 2, 5);
+  uint16_t n = countPoints(mx);
+
+  CHECK(n > 0);
+  for (uint8_t r = 0; r < ROW_SIZE; r++)
+    CHECK(!mx.getPoint(r, COLS - 5));
+  mx.clear();
+  mx.fillCircle(3, COLS + 2, 255);
+  CHECK_EQ(countPoints(mx), ROW_SIZE * COLS);
+  mx.clear();
+  mx.fillCircle(3, 32767 - 250, 255);   // right side past the end of int16_t
+  CHECK_EQ(countPoints(mx), 0);
+}
+
+void testGfx(void)
+{
+  for (uint8_t mod = MD_MAX72XX::GENERIC_HW; mod <= MD_MAX72XX::DR1CR1RR1_HW; mod++)
+  {
+    testBlit((MD_MAX72XX::moduleType_t)mod);
+    testShapes((MD_MAX72XX::moduleType_t)mod);
+    testCanvas((MD_MAX72XX::moduleType_t)mod);
+  }
+  testEdges();
+}
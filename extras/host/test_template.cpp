@@ -0,0 +1,131 @@
+/*
+MD_MAX72xx - Library for using a MAX7219/7221 LED matrix controller
+
+Unit tests for the MD_MAX72XX_T class template for all the module types.
+The template methods that use the device buffers directly are checked
+against a model of the display pixels, against an MD_MAX72XX object with
+the same module type and through a reference to the base class.
+
+Copyright (C) 2012-13 Marco Colli. All rights reserved.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include "hostTest.h"
+
+const uint8_t DEVICES = 3;
+const uint16_t COLS = DEVICES * COL_SIZE;
+
+static bool samePixels(MD_MAX72XX &mx, MD_MAX72XX &ref)
+{
+  for (uint8_t r = 0; r < ROW_SIZE; r++)
+    for (uint16_t c = 0; c < COLS; c++)
+      if (mx.getPoint(r, c) != ref.getPoint(r, c))
+        return(false);
+
+  return(true);
+}
+
+template <MD_MAX72XX::moduleType_t HW>
+static void testModule(void)
+// The reference object sends to a mock interface, so only the template object
+// is seen by the devices. Halfway through, the module type is changed through
+// the base class, which must be ignored.
+{
+  static const char *names[] = { "setPoint", "setColumn", "setColumn(buf)", "setRow", "getColumn", "getColumn(buf)", "getRow", "getPoint" };
+  MD_MAX72XX_T<HW> mt(HOST_COMMS, DEVICES);
+  MD_MAX72XX &mb = mt;
+  MD_MAX72XX_MockSPI spi;
+  MD_MAX72XX ref(HW, spi, DEVICES);
+  HostDevices hd(HW, DEVICES);
+
+  hostReset();
+  mt.begin();
+  ref.begin();
+  CHECK(hd.apply());
+
+  hostPixels_t p = readPixels(ref);
+
+  for (uint16_t n = 0; n < 400; n++)
+  {
+    const uint8_t op = testRandom() % 8;
+    const uint8_t r = testRandom() % (ROW_SIZE + 1);  // sometimes out of range
+    const uint16_t c = testRandom() % (COLS + 2);
+    const uint8_t buf = testRandom() % (DEVICES + 1);
+    const uint8_t dc = testRandom() % (COL_SIZE + 1);
+    const uint8_t value = testRandom();
+    const bool state = (testRandom() & 1) != 0;
+    bool ok = true;
+
+    if (n == 200)
+    {
+      mb.setModuleType((HW == MD_MAX72XX::FC16_HW) ? MD_MAX72XX::GENERIC_HW : MD_MAX72XX::FC16_HW);
+      mt.control(MD_MAX72XX::UPDATE, MD_MAX72XX::OFF);
+    }
+
+    switch (op)
+    {
+      case 0:
+        ok = (mt.setPoint(r, c, state) == ref.setPoint(r, c, state));
+        if ((r < ROW_SIZE) && (c < COLS)) p[r][c] = state;
+        break;
+
+      case 1:
+        ok = (mt.setColumn(c, value) == ref.setColumn(c, value));
+        for (uint8_t i = 0; (i < ROW_SIZE) && (c < COLS); i++)
+          p[i][c] = ((value >> i) & 1) != 0;
+        break;
+
+      case 2:
+        ok = (mt.setColumn(buf, dc, value) == ref.setColumn(buf, dc, value));
+        for (uint8_t i = 0; (i < ROW_SIZE) && (buf < DEVICES) && (dc < COL_SIZE); i++)
+          p[i][(buf * COL_SIZE) + dc] = ((value >> i) & 1) != 0;
+        break;
+
+      case 3:
+        ok = (mt.setRow(buf, r, value) == ref.setRow(buf, r, value));
+        for (uint8_t i = 0; (i < COL_SIZE) && (buf < DEVICES) && (r < ROW_SIZE); i++)
+          p[r][(buf * COL_SIZE) + i] = ((value >> i) & 1) != 0;
+        break;
+
+      case 4: ok = (mt.getColumn(c) == ref.getColumn(c)) && (mt.getColumn(c) == mb.getColumn(c)); break;
+      case 5: ok = (mt.getColumn(buf, dc) == ref.getColumn(buf, dc)) && (mt.getColumn(buf, dc) == mb.getColumn(buf, dc)); break;
+      case 6: ok = (mt.getRow(buf, r) == ref.getRow(buf, r)) && (mt.getRow(buf, r) == mb.getRow(buf, r)); break;
+      case 7: ok = (mt.getPoint(r, c) == ref.getPoint(r, c)) && (mt.getPoint(r, c) == mb.getPoint(r, c)); break;
+    }
+    if (n >= 200) mt.update();
+
+    CHECK(hd.apply());
+    ok = ok && showsPixels(mt, hd, p) && samePixels(mt, ref) && samePixels(mb, ref);
+    CHECK(ok);
+    if (!ok)
+      printf("  module %d %s r %d c %d buf %d dc %d\n", HW, names[op], r, c, buf, dc);
+  }
+}
+
+void testTemplate(void)
+{
+  testModule<MD_MAX72XX::GENERIC_HW>();
+  testModule<MD_MAX72XX::FC16_HW>();
+  testModule<MD_MAX72XX::PAROLA_HW>();
+  testModule<MD_MAX72XX::ICSTATION_HW>();
+  testModule<MD_MAX72XX::DR0CR0RR0_HW>();
+  testModule<MD_MAX72XX::DR0CR0RR1_HW>();
+  testModule<MD_MAX72XX::DR0CR1RR0_HW>();
+  testModule<MD_MAX72XX::DR0CR1RR1_HW>();
+  testModule<MD_MAX72XX::DR1CR0RR0_HW>();
+  testModule<MD_MAX72XX::DR1CR0RR1_HW>();
+  testModule<MD_MAX72XX::DR1CR1RR0_HW>();
+  testModule<MD_MAX72XX::DR1CR1RR1_HW>();
+}
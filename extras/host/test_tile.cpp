@@ -0,0 +1,434 @@
+/*
+MD_MAX72xx - Library for using a MAX7219/7221 LED matrix controller
+
+Unit tests for the 2D tiled displays for all the module types. The tiles
+are mapped to the devices from the wiring and mounting of each tile, and
+the display pixels are checked against a model of the 2D display after
+each operation, in the library buffers and as sent to the devices. The
+shift callbacks are checked against the data at the edges of the model.
+
+Copyright (C) 2012-13 Marco Colli. All rights reserved.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include "hostTest.h"
+
+const uint8_t DEVICES = 6;
+
+struct geometry_t
+{
+  uint8_t tileCols, tileRows;
+  MD_MAX72XX::tileWiring_t wiring;
+  MD_MAX72XX::tileRotation_t rot[DEVICES];  // in device order
+};
+
+// Model of the 2D display pixels, indexed [y][x] as for getPixel()
+typedef std::vector<std::vector<bool> > field_t;
+
+static uint8_t tileDevice(const geometry_t &g, uint8_t tx, uint8_t ty)
+// Device 0 is the top right tile and the chain runs right to left along the
+// top row. Serpentine wiring runs left to right along the odd rows.
+{
+  if ((g.wiring == MD_MAX72XX::TILE_SERPENTINE) && (ty & 1))
+    return((ty * g.tileCols) + tx);
+
+  return((ty * g.tileCols) + (g.tileCols - 1 - tx));
+}
+
+static void pixelAt(const geometry_t &g, uint16_t x, uint16_t y, uint8_t &r, uint16_t &c)
+// The row and display column of the 2D pixel (x, y), turning the tile
+// pixel (xx, yy) clockwise to the mounting of the device
+{
+  const uint8_t dev = tileDevice(g, x / COL_SIZE, y / ROW_SIZE);
+  const uint8_t xx = x % COL_SIZE;
+  const uint8_t yy = y % ROW_SIZE;
+
+  switch (g.rot[dev])
+  {
+    case MD_MAX72XX::ROT_0:   r = yy;     c = 7 - xx; break;
+    case MD_MAX72XX::ROT_90:  r = 7 - xx; c = 7 - yy; break;
+    case MD_MAX72XX::ROT_180: r = 7 - yy; c = xx;     break;
+    default:                  r = xx;     c = yy;     break;  // ROT_270
+  }
+  c += dev * COL_SIZE;
+}
+
+static bool showsField(MD_MAX72XX &mx, HostDevices &hd, const geometry_t &g, const field_t &f)
+{
+  for (uint16_t y = 0; y < f.size(); y++)
+  {
+    for (uint16_t x = 0; x < f[y].size(); x++)
+    {
+      uint8_t r;
+      uint16_t c;
+
+      pixelAt(g, x, y, r, c);
+      if ((mx.getPixel(x, y) != f[y][x]) || (mx.getPoint(r, c) != f[y][x]) || (hd.pixel(r, c) != f[y][x]))
+        return(false);
+    }
+  }
+
+  return(true);
+}
+
+static field_t transformField(MD_MAX72XX::transformType_t ttype, bool wrap, const field_t &old)
+// The expected display after the transformation of the whole 2D display
+{
+  const uint16_t w = old[0].size();
+  const uint16_t h = old.size();
+  field_t f = old;
+
+  for (uint16_t y = 0; y < h; y++)
+  {
+    for (uint16_t x = 0; x < w; x++)
+    {
+      switch (ttype)
+      {
+        case MD_MAX72XX::TSL:
+          f[y][x] = (x == w - 1) ? (wrap && old[y][0]) : old[y][x + 1];
+          break;
+        case MD_MAX72XX::TSR:
+          f[y][x] = (x == 0) ? (wrap && old[y][w - 1]) : old[y][x - 1];
+          break;
+        case MD_MAX72XX::TSU:
+          f[y][x] = (y == h - 1) ? (wrap && old[0][x]) : old[y + 1][x];
+          break;
+        case MD_MAX72XX::TSD:
+          f[y][x] = (y == 0) ? (wrap && old[h - 1][x]) : old[y - 1][x];
+          break;
+        case MD_MAX72XX::TFLR:
+          f[y][x] = old[y][w - 1 - x];
+          break;
+        case MD_MAX72XX::TFUD:
+          f[y][x] = old[h - 1 - y][x];
+          break;
+        case MD_MAX72XX::TINV:
+          f[y][x] = !old[y][x];
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  return(f);
+}
+
+// The shift callbacks, in the order they are called
+struct shiftCall_t
+{
+  bool out;   // shifted out, otherwise shifted in
+  uint8_t dev;
+  MD_MAX72XX::transformType_t ttype;
+  uint8_t data;
+};
+
+static std::vector<shiftCall_t> shiftCalls;
+static uint8_t shiftSeed = 0;   // changes the data shifted in
+
+static uint8_t shiftData(uint8_t dev, MD_MAX72XX::transformType_t ttype)
+{
+  return((dev * 29) ^ (ttype * 71) ^ shiftSeed);
+}
+
+static uint8_t cbShiftIn(uint8_t dev, MD_MAX72XX::transformType_t ttype)
+{
+  const shiftCall_t sc = { false, dev, ttype, shiftData(dev, ttype) };
+
+  shiftCalls.push_back(sc);
+
+  return(sc.data);
+}
+
+static void cbShiftOut(uint8_t dev, MD_MAX72XX::transformType_t ttype, uint8_t data)
+{
+  const shiftCall_t sc = { true, dev, ttype, data };
+
+  shiftCalls.push_back(sc);
+}
+
+static field_t shiftField(const geometry_t &g, int8_t dx, int8_t dy, bool wrap, bool cbOut, bool cbIn,
+  const field_t &old, std::vector<shiftCall_t> &calls)
+// The expected display and shift callbacks after a shift of the whole 2D display,
+// the horizontal shift first. The callbacks are made for each row of tiles, or
+// each column of tiles, with the data out of the tile at one edge then the data
+// into the tile at the other edge.
+{
+  const uint16_t w = old[0].size();
+  const uint16_t h = old.size();
+  field_t f = old;
+
+  if (dx != 0)
+  {
+    const MD_MAX72XX::transformType_t ttype = (dx < 0) ? MD_MAX72XX::TSL : MD_MAX72XX::TSR;
+    const uint16_t outX = (dx < 0) ? 0 : w - 1;
+    const uint16_t inX = (dx < 0) ? w - 1 : 0;
+    const field_t prev = f;
+
+    for (uint8_t ty = 0; ty < g.tileRows; ty++)
+    {
+      uint8_t data = 0, in = 0;
+
+      for (uint8_t i = 0; i < ROW_SIZE; i++)
+        if (prev[(ty * ROW_SIZE) + i][outX]) data |= (1 << i);
+      if (wrap)
+        in = data;
+      else
+      {
+        if (cbOut)
+        {
+          const shiftCall_t sc = { true, tileDevice(g, outX / COL_SIZE, ty), ttype, data };
+          calls.push_back(sc);
+        }
+        if (cbIn)
+        {
+          const uint8_t dev = tileDevice(g, inX / COL_SIZE, ty);
+          const shiftCall_t sc = { false, dev, ttype, shiftData(dev, ttype) };
+
+          calls.push_back(sc);
+          in = sc.data;
+        }
+      }
+
+      for (uint16_t y = ty * ROW_SIZE; y < (ty + 1) * ROW_SIZE; y++)
+        for (uint16_t x = 0; x < w; x++)
+          f[y][x] = (x == inX) ? ((in >> (y % ROW_SIZE)) & 1) : prev[y][x - dx];
+    }
+  }
+
+  if (dy != 0)
+  {
+    const MD_MAX72XX::transformType_t ttype = (dy < 0) ? MD_MAX72XX::TSU : MD_MAX72XX::TSD;
+    const uint16_t outY = (dy < 0) ? 0 : h - 1;
+    const uint16_t inY = (dy < 0) ? h - 1 : 0;
+    const field_t prev = f;
+
+    for (uint8_t tx = 0; tx < g.tileCols; tx++)
+    {
+      uint8_t data = 0, in = 0;
+
+      for (uint8_t i = 0; i < COL_SIZE; i++)
+        if (prev[outY][(tx * COL_SIZE) + i]) data |= (1 << i);
+      if (wrap)
+        in = data;
+      else
+      {
+        if (cbOut)
+        {
+          const shiftCall_t sc = { true, tileDevice(g, tx, outY / ROW_SIZE), ttype, data };
+          calls.push_back(sc);
+        }
+        if (cbIn)
+        {
+          const uint8_t dev = tileDevice(g, tx, inY / ROW_SIZE);
+          const shiftCall_t sc = { false, dev, ttype, shiftData(dev, ttype) };
+
+          calls.push_back(sc);
+          in = sc.data;
+        }
+      }
+
+      for (uint16_t y = 0; y < h; y++)
+        for (uint16_t x = tx * COL_SIZE; x < (tx + 1) * COL_SIZE; x++)
+          f[y][x] = (y == inY) ? ((in >> (x % COL_SIZE)) & 1) : prev[y - dy][x];
+    }
+  }
+
+  return(f);
+}
+
+static bool sameCalls(const std::vector<shiftCall_t> &a, const std::vector<shiftCall_t> &b)
+{
+  if (a.size() != b.size())
+    return(false);
+  for (size_t i = 0; i < a.size(); i++)
+    if ((a[i].out != b[i].out) || (a[i].dev != b[i].dev) || (a[i].ttype != b[i].ttype) || (a[i].data != b[i].data))
+      return(false);
+
+  return(true);
+}
+
+static void testErrors(void)
+{
+  MD_MAX72XX mx(MD_MAX72XX::FC16_HW, HOST_COMMS, DEVICES);
+  HostDevices hd(MD_MAX72XX::FC16_HW, DEVICES);
+
+  hostReset();
+  mx.begin();
+
+  // nothing works until there is a geometry
+  CHECK_EQ(mx.getWidth(), 0);
+  CHECK_EQ(mx.getHeight(), 0);
+  CHECK(!mx.setPixel(0, 0, true));
+  CHECK(!mx.getPixel(0, 0));
+  CHECK(!mx.transform2D(MD_MAX72XX::TINV));
+  CHECK(!mx.shift2D(1, 0));
+
+  CHECK(!mx.setGeometry(4, 2));   // wrong number of devices
+  CHECK(mx.setGeometry(3, 2));
+  CHECK_EQ(mx.getWidth(), 3 * COL_SIZE);
+  CHECK_EQ(mx.getHeight(), 2 * ROW_SIZE);
+  CHECK(!mx.setPixel(mx.getWidth(), 0, true));
+  CHECK(!mx.setPixel(0, mx.getHeight(), true));
+  CHECK(!mx.transform2D(MD_MAX72XX::TRC));
+  CHECK(!mx.shift2D(2, 0));
+  CHECK(!mx.shift2D(0, -2));
+
+  // remove the geometry
+  CHECK(mx.setGeometry(0, 0));
+  CHECK_EQ(mx.getWidth(), 0);
+  CHECK(!mx.setPixel(0, 0, true));
+  CHECK(hd.apply());
+}
+
+static void testGeometry(MD_MAX72XX::moduleType_t mod, const geometry_t &g, bool rotated)
+{
+  MD_MAX72XX mx(mod, HOST_COMMS, DEVICES);
+  HostDevices hd(mod, DEVICES);
+  field_t f(g.tileRows * ROW_SIZE, std::vector<bool>(g.tileCols * COL_SIZE, false));
+
+  hostReset();
+  mx.begin();
+  CHECK(mx.setGeometry(g.tileCols, g.tileRows, g.wiring, rotated ? g.rot : nullptr));
+  CHECK_EQ(mx.getWidth(), f[0].size());
+  CHECK_EQ(mx.getHeight(), f.size());
+  CHECK(hd.apply());
+  CHECK(showsField(mx, hd, g, f));
+
+  // random pixels drawn on the 2D display
+  for (uint16_t i = 0; i < 100; i++)
+  {
+    const uint16_t x = testRandom() % f[0].size();
+    const uint16_t y = testRandom() % f.size();
+    const bool state = (testRandom() & 3) != 0;
+
+    CHECK(mx.setPixel(x, y, state));
+    f[y][x] = state;
+  }
+  CHECK(hd.apply());
+  CHECK(showsField(mx, hd, g, f));
+
+  for (uint8_t wrap = 0; wrap < 2; wrap++)
+  {
+    mx.control(MD_MAX72XX::WRAPAROUND, wrap ? MD_MAX72XX::ON : MD_MAX72XX::OFF);
+
+    for (uint8_t t = MD_MAX72XX::TSL; t <= MD_MAX72XX::TINV; t++)
+    {
+      const MD_MAX72XX::transformType_t ttype = (MD_MAX72XX::transformType_t)t;
+
+      if (ttype == MD_MAX72XX::TRC)
+        continue;
+
+      CHECK(mx.transform2D(ttype));
+      f = transformField(ttype, wrap, f);
+      CHECK(hd.apply());
+      if (!showsField(mx, hd, g, f))
+        printf("transform2D type %d wrap %d, %ux%u tiles, module %d: wrong result\n", t, wrap, g.tileCols, g.tileRows, mod);
+      CHECK(showsField(mx, hd, g, f));
+    }
+  }
+}
+
+static void testShift(MD_MAX72XX::moduleType_t mod, const geometry_t &g)
+// Random shifts in every direction, with wraparound and each of the shift
+// callbacks. The single shifts are also made with transform2D().
+{
+  MD_MAX72XX mx(mod, HOST_COMMS, DEVICES);
+  HostDevices hd(mod, DEVICES);
+  field_t f(g.tileRows * ROW_SIZE, std::vector<bool>(g.tileCols * COL_SIZE, false));
+
+  hostReset();
+  mx.begin();
+  CHECK(mx.setGeometry(g.tileCols, g.tileRows, g.wiring, g.rot));
+  for (uint16_t y = 0; y < f.size(); y++)
+  {
+    for (uint16_t x = 0; x < f[y].size(); x++)
+    {
+      f[y][x] = (testRandom() & 1) != 0;
+      mx.setPixel(x, y, f[y][x]);
+    }
+  }
+  CHECK(hd.apply());
+
+  for (uint8_t wrap = 0; wrap < 2; wrap++)
+  {
+    mx.control(MD_MAX72XX::WRAPAROUND, wrap ? MD_MAX72XX::ON : MD_MAX72XX::OFF);
+
+    for (uint8_t cb = 0; cb < 4; cb++)
+    {
+      const bool cbOut = (cb & 1) != 0;
+      const bool cbIn = (cb & 2) != 0;
+
+      mx.setShiftDataOutCallback(cbOut ? cbShiftOut : nullptr);
+      mx.setShiftDataInCallback(cbIn ? cbShiftIn : nullptr);
+
+      for (uint8_t i = 0; i < 8; i++)
+      {
+        const int8_t dx = (testRandom() % 3) - 1;
+        const int8_t dy = (testRandom() % 3) - 1;
+        std::vector<shiftCall_t> calls;
+
+        shiftSeed = testRandom();
+        shiftCalls.clear();
+        f = shiftField(g, dx, dy, wrap, cbOut, cbIn, f, calls);
+        if ((dx == 0) != (dy == 0) && (i & 1))
+          CHECK(mx.transform2D((dx < 0) ? MD_MAX72XX::TSL : (dx > 0) ? MD_MAX72XX::TSR : (dy < 0) ? MD_MAX72XX::TSU : MD_MAX72XX::TSD));
+        else
+          CHECK(mx.shift2D(dx, dy));
+
+        // the changes are sent once
+        CHECK(hostFrames.size() <= ROW_SIZE);
+        CHECK(hd.apply());
+        if (!showsField(mx, hd, g, f))
+          printf("shift2D(%d, %d) wrap %d callbacks %d, %ux%u tiles, module %d: wrong result\n", dx, dy, wrap, cb, g.tileCols, g.tileRows, mod);
+        CHECK(showsField(mx, hd, g, f));
+        CHECK(sameCalls(shiftCalls, calls));
+      }
+    }
+  }
+}
+
+static void testModule(MD_MAX72XX::moduleType_t mod)
+// Each shape of the tiles, with each wiring and random mountings
+{
+  static const uint8_t shapes[][2] = { { 6, 1 }, { 3, 2 }, { 2, 3 }, { 1, 6 } };
+
+  for (uint8_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++)
+  {
+    for (uint8_t w = MD_MAX72XX::TILE_ZIGZAG; w <= MD_MAX72XX::TILE_SERPENTINE; w++)
+    {
+      geometry_t g;
+
+      g.tileCols = shapes[s][0];
+      g.tileRows = shapes[s][1];
+      g.wiring = (MD_MAX72XX::tileWiring_t)w;
+      for (uint8_t dev = 0; dev < DEVICES; dev++)
+        g.rot[dev] = MD_MAX72XX::ROT_0;
+      testGeometry(mod, g, false);
+
+      for (uint8_t dev = 0; dev < DEVICES; dev++)
+        g.rot[dev] = (MD_MAX72XX::tileRotation_t)(testRandom() % 4);
+      testGeometry(mod, g, true);
+      testShift(mod, g);
+    }
+  }
+}
+
+void testTile(void)
+{
+  testErrors();
+  for (uint8_t mod = MD_MAX72XX::GENERIC_HW; mod <= MD_MAX72XX::DR1CR1RR1_HW; mod++)
+    testModule((MD_MAX72XX::moduleType_t)mod);
+}
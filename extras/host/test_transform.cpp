@@ -0,0 +1,184 @@
+/*
+MD_MAX72xx - Library for using a MAX7219/7221 LED matrix controller
+
+Unit tests for the display transformations for all the module types.
+The result of each transformation is compared to a simple model of the
+display pixels, both in the library buffers and as sent to the devices.
+Built with and without USE_CANONICAL_BUFFER, the same tests check both
+buffer layouts.
+
+Copyright (C) 2012-13 Marco Colli. All rights reserved.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include "hostTest.h"
+
+const uint8_t DEVICES = 4;
+const uint16_t COLS = DEVICES * COL_SIZE;
+
+typedef bool pixels_t[ROW_SIZE][COLS];
+
+static void readPixels(MD_MAX72XX &mx, pixels_t p)
+{
+  for (uint8_t r = 0; r < ROW_SIZE; r++)
+    for (uint16_t c = 0; c < COLS; c++)
+      p[r][c] = mx.getPoint(r, c);
+}
+
+static void model(MD_MAX72XX::transformType_t ttype, bool wrap, uint8_t startDev, uint8_t endDev, const pixels_t old, pixels_t p)
+// The expected display after the transformation of devices [startDev..endDev]
+{
+  const uint16_t first = startDev * COL_SIZE;
+  const uint16_t last = ((endDev + 1) * COL_SIZE) - 1;
+
+  memcpy(p, old, sizeof(pixels_t));
+  for (uint8_t r = 0; r < ROW_SIZE; r++)
+  {
+    for (uint16_t c = first; c <= last; c++)
+    {
+      const uint16_t d = c - (c % COL_SIZE);  // first column of this device
+      const uint8_t dc = c % COL_SIZE;        // column in this device
+
+      switch (ttype)
+      {
+        case MD_MAX72XX::TSL:
+          p[r][c] = (c == first) ? (wrap && old[r][last]) : old[r][c - 1];
+          break;
+        case MD_MAX72XX::TSR:
+          p[r][c] = (c == last) ? (wrap && old[r][first]) : old[r][c + 1];
+          break;
+        case MD_MAX72XX::TSU:
+          p[r][c] = (r == ROW_SIZE - 1) ? (wrap && old[0][c]) : old[r + 1][c];
+          break;
+        case MD_MAX72XX::TSD:
+          p[r][c] = (r == 0) ? (wrap && old[ROW_SIZE - 1][c]) : old[r - 1][c];
+          break;
+        case MD_MAX72XX::TFLR:
+          p[r][c] = old[r][first + last - c];
+          break;
+        case MD_MAX72XX::TFUD:
+          p[r][c] = old[ROW_SIZE - 1 - r][c];
+          break;
+        case MD_MAX72XX::TRC:
+          p[r][c] = old[dc][d + COL_SIZE - 1 - r];
+          break;
+        case MD_MAX72XX::TINV:
+          p[r][c] = !old[r][c];
+          break;
+      }
+    }
+  }
+}
+
+static const char *name(MD_MAX72XX::transformType_t ttype)
+{
+  static const char *names[] = { "TSL", "TSR", "TSU", "TSD", "TFLR", "TFUD", "TRC", "TINV" };
+
+  return(names[ttype]);
+}
+
+static void testModule(MD_MAX72XX::moduleType_t mod)
+{
+  MD_MAX72XX mx(mod, HOST_COMMS, DEVICES);
+  HostDevices hd(mod, DEVICES);
+  pixels_t before, expect, after;
+
+  hostReset();
+  mx.begin();
+
+  for (uint8_t wrap = 0; wrap < 2; wrap++)
+  {
+    mx.control(MD_MAX72XX::WRAPAROUND, wrap ? MD_MAX72XX::ON : MD_MAX72XX::OFF);
+
+    for (uint8_t t = MD_MAX72XX::TSL; t <= MD_MAX72XX::TINV; t++)
+    {
+      const MD_MAX72XX::transformType_t ttype = (MD_MAX72XX::transformType_t)t;
+
+      // the whole display, only the middle devices, then one device buffer
+      for (uint8_t part = 0; part < 3; part++)
+      {
+        const uint8_t startDev = part;
+        const uint8_t endDev = (part == 0) ? DEVICES - 1 : (part == 1) ? DEVICES - 2 : 2;
+        bool ok = true, sent = true;
+
+        for (uint16_t c = 0; c < COLS; c++)
+          mx.setColumn(c, testRandom());
+        readPixels(mx, before);
+        hd.apply();
+
+        if (part < 2)
+        {
+          model(ttype, wrap, startDev, endDev, before, expect);
+          mx.transform(startDev, endDev, ttype);
+        }
+        else  // a device buffer only wraps around when shifted up or down
+        {
+          model(ttype, wrap && (ttype == MD_MAX72XX::TSU || ttype == MD_MAX72XX::TSD), startDev, endDev, before, expect);
+          mx.transform(startDev, ttype);
+        }
+        readPixels(mx, after);
+        sent = hd.apply();
+
+        for (uint8_t r = 0; r < ROW_SIZE; r++)
+          for (uint16_t c = 0; c < COLS; c++)
+            if ((after[r][c] != expect[r][c]) || (hd.pixel(r, c) != expect[r][c]))
+              ok = false;
+
+        CHECK(sent);
+        CHECK(ok);
+        if (!ok)
+          printf("  module %d %s wrap %d devices %d-%d\n", mod, name(ttype), wrap, startDev, endDev);
+      }
+    }
+  }
+}
+
+static void testModuleChange(void)
+// Changing the module type keeps the pixels with USE_CANONICAL_BUFFER and
+// sends them again in the new layout, otherwise the buffers are sent as they are
+{
+  MD_MAX72XX mx(MD_MAX72XX::FC16_HW, HOST_COMMS, DEVICES);
+  HostDevices hd(MD_MAX72XX::GENERIC_HW, DEVICES);
+  pixels_t before, after;
+
+  hostReset();
+  mx.begin();
+  for (uint16_t c = 0; c < COLS; c++)
+    mx.setColumn(c, testRandom());
+  readPixels(mx, before);
+
+  mx.setModuleType(MD_MAX72XX::GENERIC_HW);
+  mx.update();
+  readPixels(mx, after);
+  hd.apply();
+
+  bool same = true, shown = true;
+
+  for (uint8_t r = 0; r < ROW_SIZE; r++)
+    for (uint16_t c = 0; c < COLS; c++)
+    {
+      if (before[r][c] != after[r][c]) same = false;
+      if (after[r][c] != hd.pixel(r, c)) shown = false;
+    }
+  CHECK(same == (USE_CANONICAL_BUFFER != 0));
+  CHECK(shown);
+}
+
+void testTransform(void)
+{
+  for (uint8_t mod = MD_MAX72XX::GENERIC_HW; mod <= MD_MAX72XX::DR1CR1RR1_HW; mod++)
+    testModule((MD_MAX72XX::moduleType_t)mod);
+  testModuleChange();
+}
@@ -0,0 +1,703 @@
+/*
+MD_MAX72xx - Library for using a MAX7219/7221 LED matrix controller
+
+Unit tests for sending the display data to the devices: automatic, manual,
+partial, framed and asynchronous updates, BURST mode, bit banged SPI and
+chains of devices.
+
+Copyright (C) 2012-13 Marco Colli. All rights reserved.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <algorithm>
+#include "hostTest.h"
+
+static bool sameDisplay(MD_MAX72XX &mx, HostDevices &hd)
+// The devices show what the library has in its buffers
+{
+  for (uint8_t r = 0; r < ROW_SIZE; r++)
+    for (uint16_t c = 0; c < mx.getColumnCount(); c++)
+      if (mx.getPoint(r, c) != hd.pixel(r, c))
+        return(false);
+
+  return(true);
+}
+
+static bool onlyChain(int8_t cs, uint8_t devices)
+// At least one frame was sent and all the frames were for this chain
+{
+  for (size_t i = 0; i < hostFrames.size(); i++)
+    if ((hostFrames[i].cs != cs) || (hostFrames[i].data.size() != 2U * devices))
+      return(false);
+
+  return(!hostFrames.empty());
+}
+
+static void randomPoints(MD_MAX72XX &mx, uint16_t count)
+{
+  for (uint16_t i = 0; i < count; i++)
+    mx.setPoint(testRandom() % ROW_SIZE, testRandom() % mx.getColumnCount(), testRandom() & 1);
+}
+
+static void testBegin(void)
+{
+  const uint8_t DEVICES = 4;
+  MD_MAX72XX mx(MD_MAX72XX::FC16_HW, HOST_COMMS, DEVICES);
+  HostDevices hd(MD_MAX72XX::FC16_HW, DEVICES);
+
+  hostReset();
+  CHECK(mx.begin());
+  CHECK(hd.apply());
+  for (uint8_t dev = 0; dev < DEVICES; dev++)
+  {
+    CHECK_EQ(hd.reg(dev, 9), 0);              // no decode
+    CHECK_EQ(hd.reg(dev, 11), MAX_SCANLIMIT); // all digits
+    CHECK_EQ(hd.reg(dev, 12), 1);             // not shut down
+    CHECK_EQ(hd.reg(dev, 15), 0);             // not in test mode
+  }
+  CHECK(sameDisplay(mx, hd));
+}
+
+static void testNoBegin(void)
+// Objects that are never started can still be destroyed
+{
+  hostReset();
+  {
+    MD_MAX72XX mx(MD_MAX72XX::FC16_HW, HOST_COMMS, 4);
+  }
+#ifdef ARDUINO
+  {
+    MD_MAX72XX mx(MD_MAX72XX::GENERIC_HW, 11, 13, CS_PIN, 2);
+  }
+#endif
+  {
+    MD_MAX72XX_MockSPI spi;
+    MD_MAX72XX mx(MD_MAX72XX::PAROLA_HW, spi, 3);
+
+    CHECK(!mx.isBusy());
+    CHECK_EQ(spi.getMessages(), 0);
+  }
+  CHECK(hostFrames.empty());
+}
+
+static void testAutoUpdate(MD_MAX72XX::moduleType_t mod)
+{
+  const uint8_t DEVICES = 3;
+  MD_MAX72XX mx(mod, HOST_COMMS, DEVICES);
+  HostDevices hd(mod, DEVICES);
+
+  hostReset();
+  mx.begin();
+  for (uint8_t i = 0; i < 20; i++)
+  {
+    randomPoints(mx, 5);
+    CHECK(hd.apply());
+    CHECK(sameDisplay(mx, hd));
+  }
+}
+
+static void testManualUpdate(void)
+{
+  const uint8_t DEVICES = 6;
+  MD_MAX72XX mx(MD_MAX72XX::PAROLA_HW, HOST_COMMS, DEVICES);
+  HostDevices hd(MD_MAX72XX::PAROLA_HW, DEVICES);
+
+  hostReset();
+  mx.begin();
+  hd.apply();
+
+  mx.control(MD_MAX72XX::UPDATE, MD_MAX72XX::OFF);
+  randomPoints(mx, 200);
+  CHECK(hostFrames.empty());
+
+  // all the devices are sent each digit row that has changed in any device
+  mx.update();
+  CHECK(hostFrames.size() > 0 && hostFrames.size() <= ROW_SIZE);
+  CHECK(hd.apply());
+  CHECK(sameDisplay(mx, hd));
+
+  mx.update();  // nothing has changed
+  CHECK(hostFrames.empty());
+
+  mx.setPoint(2, 13, !mx.getPoint(2, 13));
+  mx.update();
+  CHECK(hostFrames.size() >= 1);
+  CHECK(hd.apply());
+  CHECK(sameDisplay(mx, hd));
+}
+
+static void testBurst(void)
+{
+  const uint8_t DEVICES = 4;
+  MD_MAX72XX mx(MD_MAX72XX::FC16_HW, HOST_COMMS, DEVICES);
+  HostDevices hd(MD_MAX72XX::FC16_HW, DEVICES);
+
+  hostReset();
+  mx.begin();
+  hd.apply();
+  mx.control(MD_MAX72XX::UPDATE, MD_MAX72XX::OFF);
+
+  for (uint8_t burst = 0; burst < 2; burst++)
+  {
+    mx.control(MD_MAX72XX::BURST, burst ? MD_MAX72XX::ON : MD_MAX72XX::OFF);
+    randomPoints(mx, 100);
+    hostReset();
+    mx.update();
+
+    const MD_MAX72XX::updateStats_t &s = mx.getUpdateStats();
+    uint32_t bytes = 0;
+
+    for (size_t i = 0; i < hostFrames.size(); i++)
+    {
+      bytes += hostFrames[i].data.size();
+      if (burst) CHECK_EQ(hostFrames[i].transaction, 1);
+    }
+    CHECK_EQ(s.csPulses, hostFrames.size());
+    CHECK_EQ(s.bytes, bytes);
+    CHECK_EQ(s.transactions, hostTransactions);
+    CHECK_EQ(s.transactions, burst ? 1 : hostFrames.size());
+    CHECK(hd.apply());
+    CHECK(sameDisplay(mx, hd));
+  }
+}
+
+static void testPartialBudget(void)
+// A budget smaller than one digit row still sends one row for each call
+{
+  const uint8_t DEVICES = 4;
+  MD_MAX72XX mx(MD_MAX72XX::FC16_HW, HOST_COMMS, DEVICES);
+  HostDevices hd(MD_MAX72XX::FC16_HW, DEVICES);
+  uint8_t calls = 0;
+
+  hostReset();
+  mx.begin();
+  hd.apply();
+  mx.control(MD_MAX72XX::UPDATE, MD_MAX72XX::OFF);
+  for (uint16_t c = 0; c < mx.getColumnCount(); c++)
+    mx.setColumn(c, 0xff);
+
+  while (mx.updatePartial(1) && calls < 2 * ROW_SIZE)
+  {
+    CHECK_EQ(hostFrames.size(), 1);
+    CHECK(hd.apply());
+    calls++;
+  }
+  CHECK_EQ(calls, ROW_SIZE - 1);
+  CHECK(hd.apply());
+  CHECK(sameDisplay(mx, hd));
+}
+
+static uint8_t bitCount(uint8_t v)
+{
+  uint8_t n = 0;
+
+  for (; v != 0; v &= v - 1)
+    n++;
+
+  return(n);
+}
+
+static void testDirty(MD_MAX72XX::moduleType_t mod, bool chains)
+// The pending changes are modelled as the device digits that hold the changed
+// pixels. With USE_CANONICAL_BUFFER a change to a module with digits as columns
+// sends every digit of the device. Each digit row is sent to the chains with a
+// change in the row, lowest digit first, within the updatePartial() budget.
+{
+  const uint8_t DEVICES = 6;
+  const int8_t pins[] = { 10, 9 };
+  const uint8_t devices[] = { 2, 4 };
+  MD_MAX72XX mx(mod, HOST_COMMS, DEVICES);
+  HostDevices hd(mod, DEVICES);
+  std::vector<uint8_t> chainOf(DEVICES);
+  const uint8_t chainCount = chains ? 2 : 1;
+
+  hostReset();
+  mx.begin();
+  hd.apply();
+  mx.control(MD_MAX72XX::UPDATE, MD_MAX72XX::OFF);
+  for (uint8_t dev = 0; dev < DEVICES; dev++)
+    chainOf[dev] = (chains && dev >= devices[0]) ? 1 : 0;
+  if (chains)
+  {
+    hd.setChains(2, pins, devices);
+    CHECK(mx.setChains(2, pins, devices));
+  }
+
+  for (uint8_t round = 0; round < 20; round++)
+  {
+    std::vector<uint8_t> digits(DEVICES, 0);
+    std::vector<uint8_t> chainRows(chainCount, 0);
+    MD_MAX72XX::dirtyInfo_t info;
+    uint16_t devs = 0, total = 0;
+    uint8_t rows = 0;
+    uint32_t bytes = 0;
+    const bool burst = (round & 1) != 0;
+
+    mx.control(MD_MAX72XX::BURST, burst ? MD_MAX72XX::ON : MD_MAX72XX::OFF);
+
+    // change some different pixels, none on some rounds
+    const uint8_t count = (round % 5 == 0) ? 0 : 1 + (testRandom() % 12);
+    std::vector<bool> used(ROW_SIZE * mx.getColumnCount(), false);
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+      const uint8_t r = testRandom() % ROW_SIZE;
+      const uint16_t c = testRandom() % mx.getColumnCount();
+
+      if (used[(r * mx.getColumnCount()) + c])
+        continue;
+      used[(r * mx.getColumnCount()) + c] = true;
+      mx.setPoint(r, c, !mx.getPoint(r, c));
+      digits[c / COL_SIZE] |= (1 << hd.digit(r, c));
+    }
+
+    for (uint8_t dev = 0; dev < DEVICES; dev++)
+    {
+      if (USE_CANONICAL_BUFFER && !hd.digRows() && digits[dev] != 0)
+        digits[dev] = 0xff;
+      if (digits[dev] != 0) devs++;
+      total += bitCount(digits[dev]);
+      rows |= digits[dev];
+      chainRows[chainOf[dev]] |= digits[dev];
+      CHECK_EQ(mx.getChangedDigits(dev), digits[dev]);
+    }
+    for (uint8_t k = 0; k < chainCount; k++)
+      bytes += bitCount(chainRows[k]) * 2 * (chains ? devices[k] : DEVICES);
+
+    CHECK_EQ(mx.getDirtyInfo(info), devs != 0);
+    CHECK_EQ(info.devices, devs);
+    CHECK_EQ(info.digits, total);
+    CHECK_EQ(info.rows, rows);
+    CHECK_EQ(info.bytes, bytes);
+    CHECK_EQ(info.transactions, burst ? (rows != 0) : bitCount(rows));
+    CHECK(hostFrames.empty());
+
+    // send the changes in parts, less than one row to a few rows at a time
+    const uint32_t budget = testRandom() % (6 * DEVICES);
+    uint8_t calls = 0;
+    bool more;
+
+    do
+    {
+      uint32_t left = budget;
+      uint16_t frames = 0;
+      bool sent = false;
+
+      for (uint8_t r = 0; r < ROW_SIZE; r++)
+      {
+        uint16_t size = 0, n = 0;
+
+        for (uint8_t k = 0; k < chainCount; k++)
+        {
+          if (bitRead(chainRows[k], r))
+          {
+            size += 2 * (chains ? devices[k] : DEVICES);
+            n++;
+          }
+        }
+        if (size == 0)
+          continue;
+        if ((size > left) && sent)
+          break;
+        left = (size > left) ? 0 : left - size;
+        sent = true;
+        frames += n;
+        for (uint8_t k = 0; k < chainCount; k++)
+          bitClear(chainRows[k], r);
+      }
+
+      more = mx.updatePartial(budget);
+      CHECK_EQ(hostFrames.size(), frames);
+      CHECK(hd.apply());
+      calls++;
+    } while (more && calls <= ROW_SIZE);
+
+    for (uint8_t k = 0; k < chainCount; k++)
+      CHECK_EQ(chainRows[k], 0);
+    CHECK(!mx.getDirtyInfo(info));
+    CHECK(sameDisplay(mx, hd));
+  }
+}
+
+static uint16_t updateCalls = 0;  // number of update complete callbacks
+
+static void updateDone(void)
+{
+  updateCalls++;
+}
+
+static void testFrames(MD_MAX72XX::moduleType_t mod)
+// The frame is the display when commitFrame() was called. It is sent in slices
+// of whole digit rows, lowest digit first, within the byte limit and at least
+// one row at a time, while the next frame is drawn.
+{
+  const uint8_t DEVICES = 6;
+  MD_MAX72XX mx(mod, HOST_COMMS, DEVICES);
+  HostDevices hd(mod, DEVICES);
+
+  hostReset();
+  mx.begin();
+  hd.apply();
+  mx.control(MD_MAX72XX::UPDATE, MD_MAX72XX::OFF);
+  mx.setUpdateCallback(updateDone);
+
+  for (uint8_t round = 0; round < 12; round++)
+  {
+    const bool burst = (round & 1) != 0;
+    const uint16_t maxBytes = (round % 3 == 0) ? 0 : testRandom() % (6 * DEVICES);
+    uint8_t rows = 0;
+    uint32_t bytes = 0;
+    uint8_t calls = 0;
+    bool more;
+
+    mx.control(MD_MAX72XX::BURST, burst ? MD_MAX72XX::ON : MD_MAX72XX::OFF);
+    if (round != 4)   // an empty frame
+      randomPoints(mx, 30);
+    for (uint8_t dev = 0; dev < DEVICES; dev++)
+      rows |= mx.getChangedDigits(dev);
+
+    const hostPixels_t frame = readPixels(mx);
+
+    updateCalls = 0;
+    mx.setFrameSlice(maxBytes, 0);
+    CHECK(mx.commitFrame());
+    CHECK_EQ(updateCalls, rows == 0);
+    if (rows != 0)
+      CHECK(!mx.commitFrame());   // the frame is still being sent
+
+    // the next frame is drawn while this one is sent
+    randomPoints(mx, 30);
+
+    if (round == 7)
+    {
+      // update() finishes the frame and then sends the new changes
+      mx.update();
+      CHECK(hd.apply());
+      CHECK_EQ(updateCalls, 1);
+      CHECK(sameDisplay(mx, hd));
+      continue;
+    }
+
+    do
+    {
+      uint32_t sent = 0;
+      uint16_t frames = 0;
+
+      for (uint8_t r = 0; r < ROW_SIZE; r++)
+      {
+        if (!bitRead(rows, r))
+          continue;
+        if ((sent != 0) && (maxBytes != 0) && (sent + 2 * DEVICES > maxBytes))
+          break;
+        sent += 2 * DEVICES;
+        frames++;
+        bitClear(rows, r);
+      }
+      bytes += sent;
+
+      hostTransactions = 0;
+      more = mx.serviceFrame();
+      CHECK_EQ(more, rows != 0);
+      CHECK_EQ(hostFrames.size(), frames);
+      CHECK_EQ(hostTransactions, burst ? (frames != 0) : frames);
+      CHECK_EQ(updateCalls, !more);
+      CHECK(hd.apply());
+      calls++;
+    } while (more && calls <= ROW_SIZE);
+
+    CHECK_EQ(mx.getUpdateStats().bytes, bytes);
+
+    bool shown = true;
+
+    for (uint8_t r = 0; r < ROW_SIZE; r++)
+      for (uint16_t c = 0; c < mx.getColumnCount(); c++)
+        if (hd.pixel(r, c) != frame[r][c])
+          shown = false;
+    CHECK(shown);
+
+    // the new changes are sent by the next update
+    mx.update();
+    CHECK(hd.apply());
+    CHECK(sameDisplay(mx, hd));
+  }
+}
+
+// Sends each message after a few calls to isBusy(), recording the data when the
+// transfer completes, so a change to the buffer while it is being sent is seen.
+// While held the transfer does not progress.
+class HostAsyncTransport : public MD_MAX72XX_Transport
+{
+public:
+  HostAsyncTransport(void) : hold(false), _data(nullptr), _polls(0) {};
+
+  virtual void beginTransaction(void) { hostTransactions++; };
+  virtual void endTransaction(void) { while (isBusy()) ; };
+
+  virtual void send(const uint8_t *data, uint16_t size)
+  {
+    CHECK_EQ(_polls, 0);  // the last message has completed
+    _data = data;
+    _copy.assign(data, data + size);
+    _polls = 1 + (testRandom() % 3);
+  };
+
+  virtual bool isBusy(void)
+  {
+    if (_polls == 0) return(false);
+    if (hold || --_polls != 0) return(true);
+
+    CHECK(std::equal(_copy.begin(), _copy.end(), _data));
+    hostFrameStart();
+    for (size_t i = 0; i < _copy.size(); i++)
+      hostSendByte(_data[i]);
+    hostFrameEnd(CS_PIN);
+    sendComplete();
+
+    return(false);
+  };
+
+  bool hold;    // keep the current transfer busy
+
+private:
+  const uint8_t *_data;       // the buffer being sent
+  std::vector<uint8_t> _copy; // the buffer when the transfer started
+  uint8_t _polls;             // calls to isBusy() until the transfer completes
+};
+
+static void asyncRounds(MD_MAX72XX &mx, HostDevices &hd, HostAsyncTransport *dma)
+// An update started by updateAsync() sends each digit row with changes once,
+// in one transaction, and the callback is invoked when isBusy() first returns
+// false. Without an asynchronous transport each call to isBusy() sends one row.
+{
+  hostReset();
+  mx.begin();
+  hd.apply();
+  mx.control(MD_MAX72XX::UPDATE, MD_MAX72XX::OFF);
+  mx.setUpdateCallback(updateDone);
+  CHECK(!mx.isBusy());
+
+  for (uint8_t round = 0; round < 12; round++)
+  {
+    const bool drawing = (round % 3 == 2);  // draw while the update is in progress
+    uint8_t rows = 0;
+    uint16_t calls = 0;
+    bool busy;
+
+    mx.control(MD_MAX72XX::BURST, (round & 1) ? MD_MAX72XX::ON : MD_MAX72XX::OFF);
+    if (round != 4)   // nothing to send
+      randomPoints(mx, 30);
+    for (uint8_t dev = 0; dev < mx.getDeviceCount(); dev++)
+      rows |= mx.getChangedDigits(dev);
+
+    const uint8_t n = bitCount(rows);
+    uint8_t left = n;   // rows not sent, without an asynchronous transport
+
+    hostReset();
+    updateCalls = 0;
+    CHECK(mx.updateAsync());
+    busy = (updateCalls == 0);
+    if (dma == nullptr)
+    {
+      if (left != 0) left--;
+      CHECK_EQ(hostFrames.size(), n - left);
+      CHECK_EQ(busy, left != 0);
+    }
+    else if (n > 1)
+      CHECK(busy);
+    else if (n == 0)
+      CHECK(!busy);
+
+    // another update can not start until this one is finished
+    if (busy && (dma != nullptr || left > 1))
+    {
+      const size_t frames = hostFrames.size();
+
+      if (dma != nullptr) dma->hold = true;
+      CHECK(!mx.updateAsync());
+      if (dma != nullptr) dma->hold = false;
+      if (dma == nullptr) left--;
+      CHECK_EQ(hostFrames.size(), frames + (dma == nullptr));
+    }
+
+    if (round == 7)
+    {
+      // update() finishes this update and then sends the new changes
+      randomPoints(mx, 30);
+      mx.update();
+      CHECK(!mx.isBusy());
+      CHECK_EQ(updateCalls, 1);
+      CHECK(hd.apply());
+      CHECK(sameDisplay(mx, hd));
+      continue;
+    }
+
+    while (busy && calls < 8 * ROW_SIZE)
+    {
+      const size_t frames = hostFrames.size();
+
+      if (drawing) randomPoints(mx, 2);
+      busy = mx.isBusy();
+      CHECK_EQ(updateCalls, !busy);
+      if (dma == nullptr)
+      {
+        left--;
+        CHECK_EQ(busy, left != 0);
+        CHECK_EQ(hostFrames.size(), frames + 1);
+      }
+      calls++;
+    }
+
+    CHECK(!mx.isBusy());
+    CHECK_EQ(updateCalls, 1);
+    CHECK_EQ(hostFrames.size(), n);
+    CHECK_EQ(hostTransactions, n != 0);
+    CHECK(hd.apply());
+
+    MD_MAX72XX::dirtyInfo_t info;
+
+    if (drawing)
+    {
+      // changes to the rows already sent are sent by the next update
+      mx.update();
+      CHECK(hd.apply());
+    }
+    CHECK(!mx.getDirtyInfo(info));
+    CHECK(sameDisplay(mx, hd));
+  }
+}
+
+static void testAsync(MD_MAX72XX::moduleType_t mod)
+{
+  const uint8_t DEVICES = 5;
+
+  {
+    MD_MAX72XX mx(mod, HOST_COMMS, DEVICES);
+    HostDevices hd(mod, DEVICES);
+
+    asyncRounds(mx, hd, nullptr);
+  }
+  {
+    HostAsyncTransport dma;
+    MD_MAX72XX mx(mod, dma, DEVICES);
+    HostDevices hd(mod, DEVICES);
+
+    asyncRounds(mx, hd, &dma);
+  }
+}
+
+static void testFrameTime(void)
+// A time limit for each slice uses the platform clock (micros() or <chrono>)
+{
+  const uint8_t DEVICES = 8;
+  MD_MAX72XX mx(MD_MAX72XX::FC16_HW, HOST_COMMS, DEVICES);
+  HostDevices hd(MD_MAX72XX::FC16_HW, DEVICES);
+  uint16_t calls = 0;
+
+  hostReset();
+  mx.begin();
+  hd.apply();
+  mx.control(MD_MAX72XX::UPDATE, MD_MAX72XX::OFF);
+  randomPoints(mx, 200);
+
+  mx.setFrameSlice(0, 1);
+  CHECK(mx.commitFrame());
+  while (mx.serviceFrame() && calls < 100)
+    calls++;
+  CHECK(calls < ROW_SIZE);
+  CHECK(hd.apply());
+  CHECK(sameDisplay(mx, hd));
+}
+
+#ifdef ARDUINO
+static void testBitBang(void)
+{
+  const uint8_t DEVICES = 2;
+  MD_MAX72XX mx(MD_MAX72XX::ICSTATION_HW, 11, 13, CS_PIN, DEVICES);
+  HostDevices hd(MD_MAX72XX::ICSTATION_HW, DEVICES);
+
+  hostReset();
+  mx.begin();
+  randomPoints(mx, 50);
+  CHECK(hd.apply());
+  CHECK(sameDisplay(mx, hd));
+}
+#endif
+
+static void testChains(void)
+{
+  const uint8_t DEVICES = 8;
+  const int8_t pins[] = { 10, 9 };
+  const uint8_t devices[] = { 3, 5 };
+  const uint8_t wrong[] = { 3, 4 };
+  MD_MAX72XX mx(MD_MAX72XX::GENERIC_HW, HOST_COMMS, DEVICES);
+  HostDevices hd(MD_MAX72XX::GENERIC_HW, DEVICES);
+
+  hostReset();
+  mx.begin();
+  CHECK(hd.apply());
+  hd.setChains(2, pins, devices);
+  CHECK(!mx.setChains(2, pins, wrong)); // wrong number of devices
+  CHECK(mx.setChains(2, pins, devices));
+  mx.control(MD_MAX72XX::UPDATE, MD_MAX72XX::OFF);
+  mx.clear();
+  mx.update();
+  CHECK(hd.apply());
+
+  // only the chain with the change is sent
+  mx.setPoint(3, 1 * COL_SIZE + 4, true);
+  mx.update();
+  CHECK(onlyChain(pins[0], devices[0]));
+  CHECK(hd.apply());
+
+  mx.setPoint(5, 6 * COL_SIZE + 2, true);
+  mx.update();
+  CHECK(onlyChain(pins[1], devices[1]));
+  CHECK(hd.apply());
+  CHECK(sameDisplay(mx, hd));
+
+  for (uint8_t burst = 0; burst < 2; burst++)
+  {
+    mx.control(MD_MAX72XX::BURST, burst ? MD_MAX72XX::ON : MD_MAX72XX::OFF);
+    randomPoints(mx, 100);
+    mx.update();
+    CHECK(hd.apply());
+    CHECK(sameDisplay(mx, hd));
+  }
+}
+
+void testUpdate(void)
+{
+  testBegin();
+  testNoBegin();
+  for (uint8_t mod = MD_MAX72XX::GENERIC_HW; mod <= MD_MAX72XX::DR1CR1RR1_HW; mod++)
+    testAutoUpdate((MD_MAX72XX::moduleType_t)mod);
+  testManualUpdate();
+  testBurst();
+  testPartialBudget();
+  for (uint8_t mod = MD_MAX72XX::GENERIC_HW; mod <= MD_MAX72XX::DR1CR1RR1_HW; mod++)
+  {
+    testDirty((MD_MAX72XX::moduleType_t)mod, false);
+    testDirty((MD_MAX72XX::moduleType_t)mod, true);
+  }
+  testFrameTime();
+  for (uint8_t mod = MD_MAX72XX::GENERIC_HW; mod <= MD_MAX72XX::DR1CR1RR1_HW; mod++)
+    testFrames((MD_MAX72XX::moduleType_t)mod);
+  for (uint8_t mod = MD_MAX72XX::GENERIC_HW; mod <= MD_MAX72XX::DR1CR1RR1_HW; mod++)
+    testAsync((MD_MAX72XX::moduleType_t)mod);
+#ifdef ARDUINO
+  testBitBang();
+#endif
+  testChains();
+}
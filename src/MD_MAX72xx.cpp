@@ -27,6 +27,8 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
 
 #if MBED_SPI_ACTIVE
 #include "mbed.h"
+#elif HOST_BUILD_ACTIVE
+#include <chrono>
 #endif
 
 /**
@@ -34,34 +36,83 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
  * \brief Implements class definition and general methods
  */
 
+#if !HOST_BUILD_ACTIVE
 MD_MAX72XX::MD_MAX72XX(moduleType_t mod, int8_t dataPin, int8_t clkPin, int8_t csPin, uint8_t numDevices):
 _dataPin(dataPin), _clkPin(clkPin), _csPin(csPin),
-_hardwareSPI(false), _spiRef(SPI), _maxDevices(numDevices), _updateEnabled(true)
+_hardwareSPI(false), _spiRef(SPI), _transport(nullptr), _chain(nullptr), _chainCount(0), _maxDevices(numDevices), _matrix(nullptr), _tile(nullptr), _tileCols(0), _tileRows(0), _updateEnabled(true)
 #if MBED_SPI_ACTIVE
 , _spi((PinName)dataPin, NC, (PinName)clkPin), _cs((PinName)csPin)
 #endif
 {
-  setModuleParameters(mod);
+  initObject(mod);
 }
 
 MD_MAX72XX::MD_MAX72XX(moduleType_t mod, int8_t csPin, uint8_t numDevices):
 _dataPin(0), _clkPin(0), _csPin(csPin),
-_hardwareSPI(true), _spiRef(SPI), _maxDevices(numDevices), _updateEnabled(true)
+_hardwareSPI(true), _spiRef(SPI), _transport(nullptr), _chain(nullptr), _chainCount(0), _maxDevices(numDevices), _matrix(nullptr), _tile(nullptr), _tileCols(0), _tileRows(0), _updateEnabled(true)
 #if MBED_SPI_ACTIVE
 , _spi(SPI_MOSI, NC, SPI_SCK), _cs((PinName)csPin)
 #endif
 {
-  setModuleParameters(mod);
+  initObject(mod);
 }
 
 MD_MAX72XX::MD_MAX72XX(moduleType_t mod, SPIClass& spi, int8_t csPin, uint8_t numDevices):
   _dataPin(0), _clkPin(0), _csPin(csPin),
-  _hardwareSPI(true), _spiRef(spi), _maxDevices(numDevices), _updateEnabled(true)
+  _hardwareSPI(true), _spiRef(spi), _transport(nullptr), _chain(nullptr), _chainCount(0), _maxDevices(numDevices), _matrix(nullptr), _tile(nullptr), _tileCols(0), _tileRows(0), _updateEnabled(true)
 #if MBED_SPI_ACTIVE
   , _spi(SPI_MOSI, NC, SPI_SCK), _cs((PinName)csPin)
 #endif
 {
+  initObject(mod);
+}
+
+#endif
+
+MD_MAX72XX::MD_MAX72XX(moduleType_t mod, MD_MAX72XX_Transport &transport, uint8_t numDevices):
+  _dataPin(0), _clkPin(0), _csPin(-1),
+  _hardwareSPI(false),
+#if !HOST_BUILD_ACTIVE
+  _spiRef(SPI),
+#endif
+  _transport(&transport), _chain(nullptr), _chainCount(0), _maxDevices(numDevices), _matrix(nullptr), _tile(nullptr), _tileCols(0), _tileRows(0), _updateEnabled(true)
+#if MBED_SPI_ACTIVE
+  , _spi(SPI_MOSI, NC, SPI_SCK), _cs(NC)
+#endif
+{
+  initObject(mod);
+}
+
+void MD_MAX72XX::initObject(moduleType_t mod)
+// Common constructor code. Memory is allocated in begin(), but the pointers are
+// set here so that the destructor works even if begin() was never called.
+{
+  _modFixed = false;
   setModuleParameters(mod);
+  setCanvas(nullptr, 0);
+  _canvas.colStart = 0;
+  _canvas.colEnd = getColumnCount() - 1;
+
+  _spiData = _spiNext = nullptr;
+  _asyncActive = false;
+  _cbUpdate = nullptr;
+  _frame = nullptr;
+  _frameRows = ALL_CLEAR;
+  _sliceBytes = _sliceMicros = 0;
+#if USE_LOCAL_FONT
+  _fontData = nullptr;
+  _fontSource = nullptr;
+#if USE_FONT_INDEX
+  _fontIndex = nullptr;
+#endif
+  _fontSteps = nullptr;
+  _fontStep = FONT_SOURCE_STEP;
+  _fontAhead = nullptr;
+  _aheadStart = 0;
+  _aheadLen = 0;
+  memset(_fontCache, 0, sizeof(_fontCache));
+  _fontCacheNext = 0;
+#endif
 }
 
 void MD_MAX72XX::setModuleParameters(moduleType_t mod)
@@ -92,6 +143,24 @@ void MD_MAX72XX::setModuleParameters(moduleType_t mod)
     case DR1CR1RR1_HW: // same as ICSTATION_HW, tested MC 9 March 2014
     case ICSTATION_HW: _hwDigRows = true;  _hwRevCols = true;  _hwRevRows = true;   break;
   }
+
+#if USE_CANONICAL_BUFFER
+  // The buffers always use the DR1CR0RR0_HW (pixel) layout and the module
+  // layout is only applied when the data is sent. The display data does not
+  // change, so all of it is sent again at the next update.
+  _modDigRows = _hwDigRows;
+  _modRevCols = _hwRevCols;
+  _modRevRows = _hwRevRows;
+  _hwDigRows = true;
+  _hwRevCols = false;
+  _hwRevRows = false;
+
+  if (_matrix != nullptr)
+  {
+    for (uint8_t dev = FIRST_BUFFER; dev <= LAST_BUFFER; dev++)
+      _matrix[dev].changed = ALL_CHANGED;
+  }
+#endif
 }
 
 bool MD_MAX72XX::begin(void)
@@ -99,37 +168,63 @@ bool MD_MAX72XX::begin(void)
   bool b = true;
 
   // initialize the SPI interface
-#if MBED_SPI_ACTIVE
-  _cs = 1;
-#else
-  if (_hardwareSPI)
+  if (_transport != nullptr)
   {
-    PRINTS("\nHardware SPI");
-    _spiRef.begin();
+    PRINTS("\nTransport object");
+    b = _transport->begin();
   }
   else
   {
-    PRINTS("\nBitBang SPI");
-    pinMode(_dataPin, OUTPUT);
-    pinMode(_clkPin, OUTPUT);
-  }
+#if MBED_SPI_ACTIVE
+    _cs = 1;
+#elif HOST_BUILD_ACTIVE
+    b = false;  // only the transport interface is available
+#else
+    if (_hardwareSPI)
+    {
+      PRINTS("\nHardware SPI");
+      _spiRef.begin();
+    }
+    else
+    {
+      PRINTS("\nBitBang SPI");
+      pinMode(_dataPin, OUTPUT);
+      pinMode(_clkPin, OUTPUT);
+    }
 
-  // initialize our preferred CS pin (could be same as SS)
-  pinMode(_csPin, OUTPUT);
-  digitalWrite(_csPin, HIGH);
+    // initialize our preferred CS pin (could be same as SS)
+    pinMode(_csPin, OUTPUT);
+    digitalWrite(_csPin, HIGH);
 #endif
+  }
 
   // object memory and internals
   setShiftDataInCallback(nullptr);
   setShiftDataOutCallback(nullptr);
+  _burst = false;
 #if USE_LOCAL_FONT
   setFont(_sysfont);
+#if GLYPH_CACHE_SIZE
+  memset(_glyphCache, 0, sizeof(_glyphCache));
+  _glyphClock = 0;
+#endif
+  resetGlyphCacheStats();
+  _charSpacing = 1;
+  _kernPairs = nullptr;
+  _kernCount = 0;
 #endif // INCLUDE_LOCAL_FONT
 
 
   _matrix = (deviceInfo_t *)malloc(sizeof(deviceInfo_t) * _maxDevices);
   _spiData = (uint8_t *)malloc(SPI_DATA_SIZE);
-  b = (_spiData != nullptr) && (_matrix != nullptr);
+  b = b && (_spiData != nullptr) && (_matrix != nullptr);
+#if USE_CANONICAL_BUFFER
+  if (_matrix != nullptr)
+  {
+    for (uint8_t dev = FIRST_BUFFER; dev <= LAST_BUFFER; dev++)
+      _matrix[dev].pending = ALL_CLEAR;
+  }
+#endif
 
   if (b)
   {
@@ -159,12 +254,88 @@ bool MD_MAX72XX::begin(void)
 
 MD_MAX72XX::~MD_MAX72XX(void)
 {
-#if !MBED_SPI_ACTIVE
-  if (_hardwareSPI) _spiRef.end();  // reset SPI mode
+  while (isBusy() || serviceFrame())
+    ;   // let any update finish
+  spiWait();
+#if !MBED_SPI_ACTIVE && !HOST_BUILD_ACTIVE
+  if (_hardwareSPI && _spiData != nullptr) _spiRef.end();  // reset SPI mode if begin() was called
 #endif
 
   free(_matrix);
   free(_spiData);
+  free(_spiNext);
+  free(_frame);
+  free(_chain);
+  free(_tile);
+#if USE_LOCAL_FONT
+  for (uint8_t i = 0; i < FONT_CACHE_SIZE; i++)
+  {
+#if USE_FONT_INDEX
+    free(_fontCache[i].index);
+#endif
+    free(_fontCache[i].steps);
+  }
+  free(_fontAhead);
+#endif
+}
+
+bool MD_MAX72XX::setChains(uint8_t count, const int8_t *csPins, const uint8_t *devices)
+{
+  uint16_t total = 0;
+
+  // let any update finish with the current chains
+  if (_matrix != nullptr)
+    while (isBusy() || serviceFrame())
+      ;
+
+  if (count == 0)
+  {
+    free(_chain);
+    _chain = nullptr;
+    _chainCount = 0;
+    if (_transport != nullptr) _transport->selectChain(0);  // back to the first output
+    return(true);
+  }
+
+  if (devices == nullptr || (_transport == nullptr && csPins == nullptr))
+    return(false);
+#if MBED_SPI_ACTIVE
+  if (_transport == nullptr)
+    return(false);
+#endif
+
+  for (uint8_t k = 0; k < count; k++)
+  {
+    if (devices[k] == 0)
+      return(false);
+    total += devices[k];
+  }
+  if (total != _maxDevices)
+    return(false);
+
+  free(_chain);
+  _chainCount = 0;
+  _chain = (chainInfo_t *)malloc(sizeof(chainInfo_t) * count);
+  if (_chain == nullptr)
+    return(false);
+
+  total = 0;
+  for (uint8_t k = 0; k < count; k++)
+  {
+    total += devices[k];
+    _chain[k].lastDev = total - 1;
+    _chain[k].csPin = (csPins != nullptr) ? csPins[k] : -1;
+#if !MBED_SPI_ACTIVE && !HOST_BUILD_ACTIVE
+    if (_transport == nullptr)
+    {
+      pinMode(_chain[k].csPin, OUTPUT);
+      digitalWrite(_chain[k].csPin, HIGH);
+    }
+#endif
+  }
+  _chainCount = count;
+
+  return(true);
 }
 
 void MD_MAX72XX::controlHardware(uint8_t dev, controlRequest_t mode, int value)
@@ -225,6 +396,10 @@ void MD_MAX72XX::controlLibrary(controlRequest_t mode, int value)
       _wrapAround = (value == ON);
       break;
 
+    case BURST:
+      _burst = (value == ON);
+      break;
+
     default:
       break;
   }
@@ -236,6 +411,7 @@ bool MD_MAX72XX::control(uint8_t startDev, uint8_t endDev, controlRequest_t mode
 
   if (mode < UPDATE)  // device based control
   {
+    spiUpdateStart();
     spiClearBuffer();
     for (uint8_t i = startDev; i <= endDev; i++)
       controlHardware(i, mode, value);
@@ -256,6 +432,7 @@ bool MD_MAX72XX::control(uint8_t buf, controlRequest_t mode, int value)
 
   if (mode < UPDATE)  // device based control
   {
+    spiUpdateStart();
     spiClearBuffer();
     controlHardware(buf, mode, value);
     spiSend();
@@ -269,33 +446,420 @@ bool MD_MAX72XX::control(uint8_t buf, controlRequest_t mode, int value)
 }
 
 void MD_MAX72XX::flushBufferAll()
+{
+  flushBufferRows(UINT32_MAX);
+}
+
+void MD_MAX72XX::flushBufferRows(uint32_t maxBytes)
 // Only one data byte is sent to a device, so if there are many changes, it is more
 // efficient to send a data byte all devices at the same time, substantially cutting
 // the number of communication messages required.
+// In BURST mode the SPI transaction is started once for all the rows that have 
+// changed, with only the device selection toggled between each row.
+// Rows with changes are sent lowest digit first, stopping before the bytes sent
+// would be more than maxBytes. At least one row with changes is always sent, as 
+// in serviceFrame(), so repeated calls with a small maxBytes send all the changes.
 {
+  bool inTransaction = false;
+  bool sent = false;
+
+  spiUpdateStart();
+
   for (uint8_t i=0; i<ROW_SIZE; i++)  // all data rows
   {
-    bool bChange = false; // set to true if we detected a change
+    if (maxBytes != UINT32_MAX)
+    {
+      uint16_t size = rowBytes(i);
+
+      if (size > maxBytes && sent)
+        break;
+      maxBytes = (size > maxBytes) ? 0 : maxBytes - size;
+      sent = sent || (size != 0);
+    }
 
     spiClearBuffer();
 
-    for (uint8_t dev = FIRST_BUFFER; dev <= LAST_BUFFER; dev++)	// all devices
+    if (spiBuildRow(_spiData, i))
     {
-      if (bitRead(_matrix[dev].changed, i))
+      if (!_burst)
+        spiSend();
+      else
       {
-        // put our device data into the buffer
-        _spiData[SPI_OFFSET(dev, 0)] = OP_DIGIT0+i;
-        _spiData[SPI_OFFSET(dev, 1)] = _matrix[dev].dig[i];
-        bChange = true;
+        if (!inTransaction)
+        {
+          spiBegin();
+          inTransaction = true;
+        }
+        spiFrame();
       }
     }
+  }
+
+  if (inTransaction) spiEnd();
+}
 
-  if (bChange) spiSend();
+uint8_t MD_MAX72XX::changedRows(void)
+// Return the digit rows that have changes in any device
+{
+  uint8_t rows = ALL_CLEAR;
+
+  for (uint8_t dev = FIRST_BUFFER; dev <= LAST_BUFFER; dev++)
+    rows |= flushRows(dev);
+
+  return(rows);
+}
+
+uint16_t MD_MAX72XX::rowBytes(uint8_t r)
+// Return the number of bytes that will be sent for the changes in digit r.
+// Only the chains with a change in the row are sent.
+{
+  uint16_t size = 0;
+  uint8_t dev = FIRST_BUFFER;
+
+  for (uint8_t k = 0; k < (_chainCount == 0 ? 1 : _chainCount); k++)
+  {
+    const uint8_t last = (_chainCount == 0) ? LAST_BUFFER : _chain[k].lastDev;
+    const uint8_t first = dev;
+
+    for (; dev <= last; dev++)
+    {
+      if (bitRead(flushRows(dev), r))
+      {
+        size += (last - first + 1) * 2;
+        break;
+      }
+    }
+    dev = last + 1;
   }
 
-  // mark everything as cleared
+  return(size);
+}
+
+bool MD_MAX72XX::getDirtyInfo(dirtyInfo_t &info)
+{
+  uint8_t n = 0;
+
+  memset(&info, 0, sizeof(info));
+
   for (uint8_t dev = FIRST_BUFFER; dev <= LAST_BUFFER; dev++)
+  {
+    uint8_t d = flushRows(dev);
+
+    if (d != ALL_CLEAR)
+    {
+      info.devices++;
+      info.rows |= d;
+      for (; d != 0; d &= d - 1)  // count the bits set
+        info.digits++;
+    }
+  }
+
+  // update() sends one message to each chain with a change in a row
+  for (uint8_t r = 0; r < ROW_SIZE; r++)
+  {
+    if (bitRead(info.rows, r))
+    {
+      n++;
+      info.bytes += rowBytes(r);
+    }
+  }
+  info.transactions = _burst ? (n != 0) : n;
+
+  return(info.devices != 0);
+}
+
+uint8_t MD_MAX72XX::getChangedDigits(uint8_t buf)
+{
+  if (buf > LAST_BUFFER)
+    return(ALL_CLEAR);
+
+  return(flushRows(buf));
+}
+
+bool MD_MAX72XX::updatePartial(uint32_t maxBytes)
+{
+  PRINT("\nupdatePartial bytes ", maxBytes);
+
+  flushBufferRows(maxBytes);
+
+  return(changedRows() != ALL_CLEAR);
+}
+
+#if USE_CANONICAL_BUFFER
+uint8_t MD_MAX72XX::flushRows(uint8_t buf)
+// Return the digits of the device that need to be sent, one bit per digit.
+// The changed bits in the buffer are for the pixel rows. When the module
+// digits are columns a change in any row changes every digit, so the digits
+// still to be sent are kept separately until they have all been sent.
+{
+  uint8_t changed = _matrix[buf].changed;
+
+  if (!_modDigRows)
+  {
+    if (changed != ALL_CLEAR)
+    {
+      _matrix[buf].pending = ALL_CHANGED;
+      _matrix[buf].changed = ALL_CLEAR;
+    }
+    return(_matrix[buf].pending);
+  }
+
+  return(_modRevRows ? bitReverse(changed) : changed);
+}
+
+uint8_t MD_MAX72XX::flushDigit(uint8_t buf, uint8_t d)
+// Return the data for digit d of the device in module hardware order
+// and mark the digit as sent.
+{
+  const uint8_t i = _modRevRows ? ROW_SIZE-1-d : d;  // the pixel row or column in this digit
+  uint8_t value = 0;
+
+  if (_modDigRows)
+  {
+    value = _modRevCols ? bitReverse(_matrix[buf].dig[i]) : _matrix[buf].dig[i];
+    bitClear(_matrix[buf].changed, i);
+  }
+  else
+  {
+    for (uint8_t r=0; r<ROW_SIZE; r++)
+      value |= ((_matrix[buf].dig[r] >> i) & 1) << (_modRevCols ? COL_SIZE-1-r : r);
+
+    bitClear(_matrix[buf].pending, d);
+  }
+
+  return(value);
+}
+#else
+inline uint8_t MD_MAX72XX::flushRows(uint8_t buf)
+// Return the digits of the device that need to be sent, one bit per digit.
+{
+  return(_matrix[buf].changed);
+}
+
+inline uint8_t MD_MAX72XX::flushDigit(uint8_t buf, uint8_t d)
+// Return the data for digit d of the device and mark the digit as sent.
+{
+  bitClear(_matrix[buf].changed, d);
+  return(_matrix[buf].dig[d]);
+}
+#endif
+
+bool MD_MAX72XX::spiBuildRow(uint8_t *data, uint8_t r)
+// Put the data for digit r of all the changed devices into the data buffer 
+// and mark them as cleared. The buffer must already be filled with OP_NOOP.
+// Return true if any device data was put in the buffer.
+{
+  bool bChange = false; // set to true if we detected a change
+
+  for (uint8_t dev = FIRST_BUFFER; dev <= LAST_BUFFER; dev++)	// all devices
+  {
+    if (bitRead(flushRows(dev), r))
+    {
+      // put our device data into the buffer
+      data[SPI_OFFSET(dev, 0)] = OP_DIGIT0+r;
+      data[SPI_OFFSET(dev, 1)] = flushDigit(dev, r);
+      bChange = true;
+    }
+  }
+
+  return(bChange);
+}
+
+bool MD_MAX72XX::updateAsync(void)
+{
+  uint8_t rows;
+
+  if (isBusy())
+    return(false);
+
+  // the second buffer is only needed if this method is used
+  if (_spiNext == nullptr)
+  {
+    _spiNext = (uint8_t *)malloc(SPI_DATA_SIZE);
+    if (_spiNext == nullptr)
+      return(false);
+  }
+
+  spiUpdateStart();
+  rows = changedRows();
+
+  PRINTX("\nupdateAsync rows 0x", rows);
+
+  _asyncRows = rows;
+  _asyncActive = true;
+  _asyncStaged = false;
+  if (rows != ALL_CLEAR) spiBegin();
+  isBusy();   // get things started
+
+  return(true);
+}
+
+void MD_MAX72XX::asyncStage(void)
+// Prepare the next row with changed data in the second buffer
+{
+  while (!_asyncStaged && _asyncRows != ALL_CLEAR)
+  {
+    uint8_t r = 0;
+
+    while (!bitRead(_asyncRows, r)) r++;
+    bitClear(_asyncRows, r);
+
+    // the row may have nothing to send if it has been sent by another update
+    memset(_spiNext, OP_NOOP, SPI_DATA_SIZE);
+    _asyncStaged = spiBuildRow(_spiNext, r);
+  }
+}
+
+bool MD_MAX72XX::isBusy(void)
+// Service the asynchronous update. The next row is prepared in the second
+// buffer while the current one is being sent, then the buffers are swapped
+// and the next row sent when the transport is free.
+{
+  bool txBusy;
+
+  if (!_asyncActive)
+    return(false);
+
+  asyncStage();
+  txBusy = (_transport != nullptr && _transport->isBusy());
+
+  if (_asyncStaged && !txBusy)
+  {
+    // swap the buffers, send and prepare the next row while it is going out
+    uint8_t *p = _spiData;
+
+    _spiData = _spiNext;
+    _spiNext = p;
+    _asyncStaged = false;
+    spiFrame();
+    asyncStage();
+    txBusy = (_transport != nullptr && _transport->isBusy());
+  }
+
+  if (_asyncStaged || _asyncRows != ALL_CLEAR || txBusy)
+    return(true);
+
+  // all done, a transaction was only started if there was something to send
+  if (_updateStats.transactions != 0) spiEnd();
+  _asyncActive = false;
+  if (_cbUpdate != nullptr) (*_cbUpdate)();
+
+  return(false);
+}
+
+bool MD_MAX72XX::commitFrame(void)
+{
+  if (_frameRows != ALL_CLEAR)
+    return(false);
+
+  // the frame copy is only needed if this method is used
+  if (_frame == nullptr)
+  {
+    _frame = (deviceInfo_t *)malloc(sizeof(deviceInfo_t) * _maxDevices);
+    if (_frame == nullptr)
+      return(false);
+  }
+
+  spiUpdateStart();
+
+  // take the changes into the frame, new changes are for the next frame
+  memcpy(_frame, _matrix, sizeof(deviceInfo_t) * _maxDevices);
+  for (uint8_t dev = FIRST_BUFFER; dev <= LAST_BUFFER; dev++)
+  {
     _matrix[dev].changed = ALL_CLEAR;
+#if USE_CANONICAL_BUFFER
+    _matrix[dev].pending = ALL_CLEAR;
+#endif
+  }
+
+  // work out the rows to send from the frame copy
+  {
+    deviceInfo_t *m = _matrix;
+
+    _matrix = _frame;
+    _frameRows = changedRows();
+    _matrix = m;
+  }
+
+  PRINTX("\ncommitFrame rows 0x", _frameRows);
+
+  // nothing to send, so the frame is already finished
+  if (_frameRows == ALL_CLEAR && _cbUpdate != nullptr) (*_cbUpdate)();
+
+  return(true);
+}
+
+uint32_t MD_MAX72XX::sliceTime(void)
+{
+#if MBED_SPI_ACTIVE
+  return(us_ticker_read());
+#elif HOST_BUILD_ACTIVE
+  return((uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#else
+  return(micros());
+#endif
+}
+
+bool MD_MAX72XX::serviceFrame(void)
+// Send digit rows of the frame until the next one would go past the slice 
+// limits. In BURST mode the rows in the slice are sent in one SPI transaction.
+// The buffer building methods work on _matrix, so it is pointed at the frame
+// copy while the rows are built.
+{
+  const uint32_t start = (_sliceMicros != 0) ? sliceTime() : 0;
+  deviceInfo_t *m = _matrix;
+  bool inTransaction = false;
+  uint32_t bytes = 0;
+
+  if (_frameRows == ALL_CLEAR)
+    return(false);
+
+  _matrix = _frame;
+  while (_frameRows != ALL_CLEAR)
+  {
+    uint8_t r = 0;
+    uint16_t size;
+
+    while (!bitRead(_frameRows, r)) r++;
+    size = rowBytes(r);
+
+    // always send at least one row so that the frame is eventually finished
+    if (bytes != 0)
+    {
+      if (_sliceBytes != 0 && bytes + size > _sliceBytes)
+        break;
+      if (_sliceMicros != 0 && sliceTime() - start >= _sliceMicros)
+        break;
+    }
+
+    bitClear(_frameRows, r);
+    spiClearBuffer();
+    if (spiBuildRow(_spiData, r))
+    {
+      bytes += size;
+      if (!_burst)
+        spiSend();
+      else
+      {
+        if (!inTransaction)
+        {
+          spiBegin();
+          inTransaction = true;
+        }
+        spiFrame();
+      }
+    }
+  }
+
+  if (inTransaction) spiEnd();
+  _matrix = m;
+
+  if (_frameRows != ALL_CLEAR)
+    return(true);
+
+  if (_cbUpdate != nullptr) (*_cbUpdate)();
+
+  return(false);
 }
 
 void MD_MAX72XX::flushBuffer(uint8_t buf)
@@ -308,16 +872,18 @@ void MD_MAX72XX::flushBuffer(uint8_t buf)
   if (buf > LAST_BUFFER)
     return;
 
+  spiUpdateStart();
+
   for (uint8_t i = 0; i < ROW_SIZE; i++)
   {
-    if (bitRead(_matrix[buf].changed, i))
+    if (bitRead(flushRows(buf), i))
     {
       PRINT("", i);
       spiClearBuffer();
 
       // put our device data into the buffer
       _spiData[SPI_OFFSET(buf, 0)] = OP_DIGIT0+i;
-      _spiData[SPI_OFFSET(buf, 1)] = _matrix[buf].dig[i];
+      _spiData[SPI_OFFSET(buf, 1)] = flushDigit(buf, i);
 
       spiSend();
     }
@@ -328,37 +894,194 @@ void MD_MAX72XX::flushBuffer(uint8_t buf)
 inline void MD_MAX72XX::spiClearBuffer(void)
 // Clear out the spi data array
 {
+  spiWait();
   memset(_spiData, OP_NOOP, SPI_DATA_SIZE);
 }
 
+void MD_MAX72XX::spiUpdateStart(void)
+// Finish any update in progress and reset the statistics for the new one
+{
+  while (isBusy() || serviceFrame())
+    ;   // just wait
+  memset(&_updateStats, 0, sizeof(_updateStats));
+}
+
+void MD_MAX72XX::spiWait(void)
+// An asynchronous transport may still be sending the buffer
+{
+  if (_transport != nullptr)
+    while (_transport->isBusy())
+      ;  // just wait
+}
+
 void MD_MAX72XX::spiSend(void)
+// Send the SPI buffer as a single transaction
+{
+  spiBegin();
+  spiFrame();
+  spiEnd();
+}
+
+void MD_MAX72XX::spiBegin(void)
+{
+  _updateStats.transactions++;
+  if (_transport != nullptr)
+  {
+    _transport->beginTransaction();
+    return;
+  }
+#if !MBED_SPI_ACTIVE && !HOST_BUILD_ACTIVE
+  // initialize the standard SPI transaction
+  if (_hardwareSPI)
+    _spiRef.beginTransaction(SPISettings(8000000, MSBFIRST, SPI_MODE0));
+#endif
+}
+
+void MD_MAX72XX::spiFrame(void)
+// Select the devices, shift out the data and latch it in the devices.
+// When the devices are split into chains only the chains with data are sent.
+{
+  uint8_t first = FIRST_BUFFER;
+
+  if (_chainCount == 0)
+  {
+    spiChainFrame(0, 0, SPI_DATA_SIZE);
+    return;
+  }
+
+  for (uint8_t k = 0; k < _chainCount; k++)
+  {
+    // the chain data is a contiguous part of the SPI buffer, last device first
+    const uint16_t offset = SPI_OFFSET(_chain[k].lastDev, 0);
+    const uint16_t size = (_chain[k].lastDev - first + 1) * 2;
+
+    for (uint16_t i = offset; i < offset + size; i += 2)
+    {
+      if (_spiData[i] != OP_NOOP)
+      {
+        spiWait();
+        spiChainFrame(k, offset, size);
+        break;
+      }
+    }
+    first = _chain[k].lastDev + 1;
+  }
+}
+
+void MD_MAX72XX::spiChainFrame(uint8_t chain, uint16_t offset, uint16_t size)
+// Send size bytes from offset in the SPI buffer to one chain of devices
 {
+  uint8_t *data = _spiData + offset;
+
+  _updateStats.csPulses++;
+  _updateStats.bytes += size;
+
+  if (_transport != nullptr)
+  {
+    if (_chainCount != 0) _transport->selectChain(chain);
+    _transport->send(data, size);
+    return;
+  }
+
 #if MBED_SPI_ACTIVE
   // mbed definitions active
   _cs = 0;
-  _spi.write((const char*)_spiData, SPI_DATA_SIZE, nullptr, 0);
+  _spi.write((const char*)data, size, nullptr, 0);
   _cs = 1;
-#else
-  // initialize the standard SPI transaction
-  if (_hardwareSPI)
-    _spiRef.beginTransaction(SPISettings(8000000, MSBFIRST, SPI_MODE0));
-  digitalWrite(_csPin, LOW);
+#elif !HOST_BUILD_ACTIVE
+  const int8_t cs = (_chainCount != 0) ? _chain[chain].csPin : _csPin;
+
+  digitalWrite(cs, LOW);
 
   // shift out the data
   if (_hardwareSPI)
   {
-    for (uint16_t i = 0; i < SPI_DATA_SIZE; i++)
-      _spiRef.transfer(_spiData[i]);
+#if USE_SPI_BLOCK
+    // the received data overwrites the buffer, but it is always rebuilt before the next send
+    _spiRef.transfer(data, size);
+#else
+    for (uint16_t i = 0; i < size; i++)
+      _spiRef.transfer(data[i]);
+#endif
   }
   else  // not hardware SPI - bit bash it out
   {
-    for (uint16_t i = 0; i < SPI_DATA_SIZE; i++)
-      shiftOut(_dataPin, _clkPin, MSBFIRST, _spiData[i]);
+    for (uint16_t i = 0; i < size; i++)
+      shiftOut(_dataPin, _clkPin, MSBFIRST, data[i]);
   }
 
+  digitalWrite(cs, HIGH);
+#endif
+}
+
+void MD_MAX72XX::spiEnd(void)
+{
+  if (_transport != nullptr)
+  {
+    _transport->endTransaction();
+    return;
+  }
+#if !MBED_SPI_ACTIVE && !HOST_BUILD_ACTIVE
   // end the SPI transaction
-  digitalWrite(_csPin, HIGH);
   if (_hardwareSPI)
     _spiRef.endTransaction();
 #endif
 }
+
+#if defined(TEENSYDUINO)
+bool MD_MAX72XX_AsyncSPI::begin(void)
+{
+  _spi.begin();
+  pinMode(_csPin, OUTPUT);
+  digitalWrite(_csPin, HIGH);
+  for (uint8_t k = 0; k < _csCount; k++)
+  {
+    pinMode(_csPins[k], OUTPUT);
+    digitalWrite(_csPins[k], HIGH);
+  }
+  _event.setContext(this);
+  _event.attachImmediate(eventHandler);
+
+  return(true);
+}
+
+void MD_MAX72XX_AsyncSPI::beginTransaction(void)
+{
+  _spi.beginTransaction(SPISettings(8000000, MSBFIRST, SPI_MODE0));
+}
+
+void MD_MAX72XX_AsyncSPI::endTransaction(void)
+{
+  while (_busy)
+    ;   // wait for the last transfer to finish
+  _spi.endTransaction();
+}
+
+void MD_MAX72XX_AsyncSPI::send(const uint8_t *data, uint16_t size)
+{
+  while (_busy)
+    ;   // only one transfer at a time
+  _busy = true;
+  digitalWrite(_csPin, LOW);
+  _spi.transfer(data, nullptr, size, _event);
+}
+
+void MD_MAX72XX_AsyncSPI::selectChain(uint8_t chain)
+// The transfer complete event releases _csPin, so it is only changed when idle
+{
+  while (_busy)
+    ;   // wait for the last transfer to finish
+  if (chain < _csCount)
+    _csPin = _csPins[chain];
+}
+
+void MD_MAX72XX_AsyncSPI::eventHandler(EventResponderRef event)
+// Transfer is complete - latch the data into the devices
+{
+  MD_MAX72XX_AsyncSPI *p = (MD_MAX72XX_AsyncSPI *)event.getContext();
+
+  digitalWrite(p->_csPin, HIGH);
+  p->_busy = false;
+  p->sendComplete();
+}
+#endif
@@ -7,16 +7,26 @@
 
 // Define the selection criteria for MBED SPI handling activation
 #define MBED_SPI_ACTIVE (defined(__MBED__) && !defined(ARDUINO))
+// Define the selection criteria for a host (eg, PC) build with no hardware SPI
+#define HOST_BUILD_ACTIVE (!defined(__MBED__) && !defined(ARDUINO))
 
 #if MBED_SPI_ACTIVE
 #warning "INFO: MBED SPI interface selected."
+#elif HOST_BUILD_ACTIVE
+#warning "INFO: HOST build, MD_MAX72XX_Transport interface only."
 #else
 #warning "INFO: ARDUINO SPI interface selected."
 #endif
 
-#if defined(__MBED__) && !defined(ARDUINO)
+#if !defined(ARDUINO)
+#if defined(__MBED__)
 #include "mbed.h"
 #define delay   ThisThread::sleep_for
+#else
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
 #ifndef PROGMEM
  #define PROGMEM
 #endif
@@ -47,7 +57,9 @@
 #else
 #include <Arduino.h>
 #endif
+#if !HOST_BUILD_ACTIVE
 #include <SPI.h>
+#endif
 
 /**
 \mainpage Arduino LED Matrix Library
@@ -99,6 +111,37 @@ License along with this library; if not, write to the Free Software
 Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
 
 \page pageRevisionHistory Revision History
+Oct 2026 version 3.6.0
+- Added USE_FONT_INDEX option for constant time character lookup in the font table.
+- Font properties found in a single pass of the font table, cached for FONT_CACHE_SIZE fonts and available from getFontInfo().
+- Added BURST control option to send all changed rows in one SPI transaction and getUpdateStats() method.
+- Added USE_SPI_BLOCK option and MD_MAX72XX_Transport class for alternative (DMA, mock) communications.
+- Added updateAsync(), isBusy() and setUpdateCallback() for non-blocking display updates.
+- Library can be compiled on a host computer (HOST_BUILD_ACTIVE) using the MD_MAX72XX_Transport interface.
+- Added Arduino stubs, Makefile and unit tests in extras/host to build and test the library on a host computer.
+- Added MD_MAX72xx_Benchmark example to measure time and SPI data used by library functions.
+- TSL/TSR across devices shift whole digit rows with carry between devices for DR1 hardware types.
+- Fixed TSL across devices not working for more than 127 devices.
+- Fixed TSL, TSR, TSU and TSD for DR0 module types with columns not reversed or rows reversed.
+- Added 8x8 bit transpose for TRC and for getBuffer()/setBuffer() on DR1 hardware types.
+- Added USE_BITREVERSE_TABLE option for a lookup table to reverse bits.
+- Added MD_MAX72XX_T class template with the module type fixed at compile time.
+- Added USE_CANONICAL_BUFFER option to apply the module layout only when data is sent.
+- Added blit() method with clipping and raster operations.
+- Added drawLine(), drawRect(), fillRect(), drawCircle(), fillCircle() and floodFill() graphics methods.
+- Added getDirtyInfo(), getChangedDigits() and updatePartial() to query and send pending changes within a budget.
+- Added commitFrame(), serviceFrame() and setFrameSlice() for time sliced updates of complete frames.
+- Added setChains() to drive the devices as separate chains, only sending data to the chains that have changed.
+- Added setGeometry(), setPixel(), getPixel() and transform2D() for 2D displays of tiled devices.
+- Added shift2D() for vertical and diagonal shifts with carry between rows of tiles and shift callbacks at every edge.
+- TSU/TSD move whole digits for DR1 hardware types.
+- Added setCanvas(), setCanvasWindow() and setViewport() to scroll a bitmap in RAM or PROGMEM by changing the offset.
+- Added renderText() to render or measure a string in one pass, with setTextSpacing() and setKerning().
+- Added getTextWidth() and getCharWidth(), and UTF-8 or 16 bit character strings for fonts with 16 bit character codes.
+- Added GLYPH_CACHE_SIZE option for a least recently used character cache in RAM, getGlyphCacheStats() and clearFontCache().
+- Added setFontSource() and MD_MAX72XX_FontSource classes to read fonts from RAM or a file instead of PROGMEM, with FONT_SOURCE_INDEX_MAX and USE_STDIO_FONT options.
+- Added version 3 font format with a range table and character directory for sparse 16 bit fonts, written by txt2font.
+
 Dec 2023 version 3.5.1
 - Reworked ESP8266 example to be ESP32 as this is more common now.
 
@@ -325,8 +368,23 @@ The LD signal is used to select the entire device chain. This allows separate LD
 outputs to control multiple displays sharing the same DIN and CLK signals. The
 software needs to instantiate a separate object for each display.
 
+Alternatively, all communications with the devices can be handled by an object derived
+from the MD_MAX72XX_Transport class that is passed to the class constructor. This allows
+the use of interfaces not built into the library, such as DMA transfers. The 
+MD_MAX72XX_MockSPI class implements an interface that needs no hardware and counts the
+data sent, useful for testing and measuring the library. An asynchronous DMA interface
+(MD_MAX72XX_AsyncSPI) is included for Teensy boards.
+
 The remaining interface pins are for +5V and GND. The power supply must be able to supply
 enough current for the number of connected modules.
+
+Host Builds
+-----------
+When neither ARDUINO nor __MBED__ is defined (eg, compiling with the native C++ compiler
+on a PC) the library provides its own definitions for the few Arduino features it uses and
+only the MD_MAX72XX_Transport constructor is available. Together with MD_MAX72XX_MockSPI,
+this allows the library source files to be compiled into test and profiling programs
+on the development computer.
 */
 
 /**
@@ -340,6 +398,144 @@ enough current for the number of connected modules.
 #define USE_LOCAL_FONT 1
 #endif
 
+/**
+ \def USE_FONT_INDEX
+ Set to 1 to build an index of character offsets in RAM when a font is
+ selected with setFont(). Character lookup then takes the same time for
+ every character in the font instead of searching the font table from the
+ first character. The index uses 2 bytes of RAM for each character in the
+ font. Set to 0 (default) to search the font table for each character.
+ Only used if USE_LOCAL_FONT is also enabled.
+ */
+#ifndef USE_FONT_INDEX
+#define USE_FONT_INDEX 0
+#endif
+
+/**
+ \def FONT_CACHE_SIZE
+ The number of font tables for which setFont() remembers the font
+ properties (and the character index if USE_FONT_INDEX is enabled).
+ Selecting a font that is in the cache does not need to scan the font
+ table again, so applications that switch between a small number of
+ fonts should set this to at least the number of fonts used. Minimum 1.
+ Only used if USE_LOCAL_FONT is also enabled.
+ */
+#ifndef FONT_CACHE_SIZE
+#define FONT_CACHE_SIZE 2
+#endif
+
+/**
+ \def GLYPH_CACHE_SIZE
+ The number of characters kept in RAM by the character methods (setChar(),
+ getChar() and renderText()). Measuring with getTextWidth() and getCharWidth()
+ uses characters already in the cache but does not add any. The least recently used
+ character is replaced when a character not in the cache is needed, so
+ applications that show the same few characters over and over (eg, the
+ digits of a clock) should set this to at least the number of characters
+ used. Each entry uses GLYPH_CACHE_WIDTH plus 4 to 8 bytes of RAM, depending
+ on the size of a pointer. Set to 0 (default) to read every character from
+ the font table. Use getGlyphCacheStats() to tune the size.
+ Only used if USE_LOCAL_FONT is also enabled.
+ */
+#ifndef GLYPH_CACHE_SIZE
+#define GLYPH_CACHE_SIZE 0
+#endif
+
+/**
+ \def GLYPH_CACHE_WIDTH
+ The widest character, in columns, that can be held in the character cache.
+ Wider characters are always read from the font table.
+ Only used if GLYPH_CACHE_SIZE is not 0.
+ */
+#ifndef GLYPH_CACHE_WIDTH
+#define GLYPH_CACHE_WIDTH 8
+#endif
+
+/**
+ \def FONT_READ_AHEAD
+ The number of bytes read in one block from a font set with setFontSource().
+ Font data is read through a buffer of this size, allocated when the first
+ font source is set, so that the bytes of a character and the width bytes
+ of the characters that follow it need only one read from the source.
+ Only used if USE_LOCAL_FONT is also enabled.
+ */
+#ifndef FONT_READ_AHEAD
+#define FONT_READ_AHEAD 32
+#endif
+
+/**
+ \def FONT_SOURCE_STEP
+ The number of characters between entries in the offset index built for a
+ font set with setFontSource(). Finding a character reads at most this
+ number of width bytes from the source after the nearest index entry. The
+ index uses 4 bytes of RAM for every FONT_SOURCE_STEP characters in the font,
+ up to FONT_SOURCE_INDEX_MAX entries, for each font in the font cache
+ (FONT_CACHE_SIZE). If USE_FONT_INDEX is enabled and the full index can be
+ built it is used instead. Version 3 fonts do not need the index. Only used
+ if USE_LOCAL_FONT is also enabled.
+ */
+#ifndef FONT_SOURCE_STEP
+#define FONT_SOURCE_STEP 16
+#endif
+
+/**
+ \def FONT_SOURCE_INDEX_MAX
+ The maximum number of entries in the offset index built for a font set with
+ setFontSource(), which limits the index to 4*FONT_SOURCE_INDEX_MAX bytes of
+ RAM for each cached font. For fonts with more than FONT_SOURCE_INDEX_MAX *
+ FONT_SOURCE_STEP characters the entries are spread further apart, so more
+ width bytes are read to find a character. If the RAM for the index cannot be
+ allocated, characters are found by reading the width byte of every character
+ from the start of the font. Only used if USE_LOCAL_FONT is also enabled.
+ */
+#ifndef FONT_SOURCE_INDEX_MAX
+#define FONT_SOURCE_INDEX_MAX 64
+#endif
+
+/**
+ \def USE_STDIO_FONT
+ Set to 1 to include the MD_MAX72XX_StdioFont class, a font source for a file
+ opened with the C library fopen(). This is the default for host builds
+ (HOST_BUILD_ACTIVE), eg to test fonts written by the txt2font utility. Set to
+ 0 for other builds, as most Arduino platforms do not support C library files.
+ Only used if USE_LOCAL_FONT is also enabled.
+ */
+#ifndef USE_STDIO_FONT
+#if HOST_BUILD_ACTIVE
+#define USE_STDIO_FONT 1
+#else
+#define USE_STDIO_FONT 0
+#endif
+#endif
+
+/**
+ \def USE_BITREVERSE_TABLE
+ Set to 1 to reverse the bits in a byte using a 256 byte lookup table
+ stored in PROGMEM. Bits are reversed when rows are read or written on
+ hardware with reversed columns (eg, PAROLA_HW and ICSTATION_HW) and for
+ the TFLR/TFUD transformations. Set to 0 (default) to calculate the
+ reversed value, which is slower but does not use the additional memory.
+ */
+#ifndef USE_BITREVERSE_TABLE
+#define USE_BITREVERSE_TABLE 0
+#endif
+
+/**
+ \def USE_CANONICAL_BUFFER
+ Set to 1 to keep the display data in the device buffers in the same
+ layout for all module types (each device digit holds one pixel row, with
+ column 0 in bit 0), and to convert the data to the module layout only when it
+ is sent to the devices. The drawing and transformation methods then
+ always use the simplest (DR1CR0RR0_HW) processing, and setModuleType() can
+ be used at run time without redrawing the display, as the buffer data does
+ not depend on the module type. The conversion takes extra time for each
+ digit sent, particularly for modules with digits as columns (DR0 types).
+ Set to 0 (default) to keep the data in the module hardware layout.
+ */
+#ifndef USE_CANONICAL_BUFFER
+#define USE_CANONICAL_BUFFER 0
+#endif
+
 // Display parameter constants
 // Defined values that are used throughout the library to define physical limits
 #define ROW_SIZE  8   ///< The size in pixels of a row in the device LED matrix array
@@ -348,247 +544,855 @@ enough current for the number of connected modules.
 #define MAX_SCANLIMIT 7   ///< The maximum scan limit value that can be set for the devices
 
 /**
- * Core object for the MD_MAX72XX library
+ \def USE_SPI_BLOCK
+ Set to 1 to send the data for all the devices with one call to the
+ SPIClass::transfer(buffer, size) method when using hardware SPI. This
+ removes the overhead of one call per byte, which is significant for long
+ chains of devices. Set to 0 (default) to send the data one byte at a time,
+ for SPI libraries that do not implement the buffer transfer method.
  */
-class MD_MAX72XX
+#ifndef USE_SPI_BLOCK
+#define USE_SPI_BLOCK 0
+#endif
+
+/**
+ * Base class for alternative communications with the MAX72xx devices.
+ *
+ * The library normally uses the hardware SPI interface or bit bashed digital
+ * outputs, depending on the class constructor used. An object derived from
+ * this class can be passed to the MD_MAX72XX constructor to replace the
+ * built-in communications (eg, for a DMA controller, a different bus or for
+ * testing without hardware).
+ *
+ * Each call to send() is one complete message to the devices; the derived class
+ * is responsible for selecting the devices (CS/LD low), sending the data and
+ * latching it (CS/LD high). The library may group several messages between
+ * beginTransaction() and endTransaction() calls.
+ *
+ * A derived class may send the data asynchronously (eg, using DMA). In this case
+ * send() returns as soon as the transfer has started and isBusy() returns true
+ * until it completes. The library does not change the data buffer until isBusy()
+ * returns false. The derived class should call sendComplete() when the transfer
+ * has finished to invoke the user callback, if one is set.
+ */
+class MD_MAX72XX_Transport
 {
 public:
   /**
-  * Module Type enumerated type.
-  *
-  * This enumerated type is used to defined the type of
-  * modules being used in the application. The types of modules are
-  * discussed in detail in the Hardware section of this documentation.
-  * For structured name types see \ref pageNewHardware.
-  * Short Form: DR - Digits as rows; CR - Columns Reversed; RR - Rows Reversed
-  */
-  enum moduleType_t
-  {
-    GENERIC_HW,   ///< Use 'generic' style hardware modules commonly available.
-    FC16_HW,      ///< Use FC-16 style hardware module.
-    PAROLA_HW,    ///< Use the Parola style hardware modules.
-    ICSTATION_HW, ///< Use ICStation style hardware module.
-
-    DR0CR0RR0_HW, ///< Structured name
-    DR0CR0RR1_HW, ///< Structured name
-    DR0CR1RR0_HW, ///< Structured name; equivalent to GENERIC_HW
-    DR0CR1RR1_HW, ///< Structured name
-    DR1CR0RR0_HW, ///< Structured name; equivalent to FC16_HW
-    DR1CR0RR1_HW, ///< Structured name
-    DR1CR1RR0_HW, ///< Structured name; equivalent to PAROLA_HW
-    DR1CR1RR1_HW  ///< Structured name; equivalent to ICSTATION_HW
-  };
+   * Class Constructor.
+   */
+  MD_MAX72XX_Transport(void) : _cbComplete(nullptr) {};
 
-#if USE_LOCAL_FONT
   /**
-  * Font definition type.
-  *
-  * This type is used in the setFont() method to set the font to be used
-  */
-  typedef  const uint8_t fontType_t;
-#endif
+   * Class Destructor.
+   */
+  virtual ~MD_MAX72XX_Transport(void) {};
 
   /**
-  * Control Request enumerated type.
-  *
-  * This enumerated type is used with the control() method to identify
-  * the control action request.
-  */
-  enum controlRequest_t
-  {
-    SHUTDOWN = 0,   ///< Shut down the MAX72XX. Requires ON/OFF value. Library default is OFF.
-    SCANLIMIT = 1,  ///< Set the scan limit for the MAX72XX. Requires numeric value [0..MAX_SCANLIMIT]. Library default is all on.
-    INTENSITY = 2,  ///< Set the LED intensity for the MAX72XX. Requires numeric value [0..MAX_INTENSITY]. LIbrary default is MAX_INTENSITY/2.
-    TEST = 3,       ///< Set the MAX72XX in test mode. Requires ON/OFF value. Library default is OFF.
-    DECODE = 4,     ///< Set the MAX72XX 7 segment decode mode. Requires ON/OFF value. Library default is OFF.
-    UPDATE = 10,    ///< Enable or disable auto updates of the devices from the library. Requires ON/OFF value. Library default is ON.
-    WRAPAROUND = 11 ///< Enable or disable wraparound when shifting (circular buffer). Requires ON/OFF value. Library default is OFF.
-  };
+   * Initialize the communications interface.
+   *
+   * Called from MD_MAX72XX::begin().
+   *
+   * \return true if initialized with no error, false otherwise.
+   */
+  virtual bool begin(void) { return(true); };
 
   /**
-  * Control Value enumerated type.
-  *
-  * This enumerated type is used with the control() method as the
-  * ON/OFF value for a control request. Other values may be used
-  * if numeric data is required.
-  */
-  enum controlValue_t
-  {
-    OFF = 0,  ///< General OFF status request
-    ON = 1    ///< General ON status request
-  };
+   * Start a group of messages.
+   *
+   * Interface settings (eg, SPI speed and mode) should be applied here.
+   */
+  virtual void beginTransaction(void) {};
 
   /**
-   * Transformation Types enumerated type.
-  *
-  * This enumerated type is used in the transform() methods to identify a
-  * specific transformation of the display data in the device buffers.
-  */
-  enum transformType_t
-  {
-    TSL,  ///< Transform Shift Left one pixel element
-    TSR,  ///< Transform Shift Right one pixel element
-    TSU,  ///< Transform Shift Up one pixel element
-    TSD,  ///< Transform Shift Down one pixel element
-    TFLR, ///< Transform Flip Left to Right
-    TFUD, ///< Transform Flip Up to Down
-    TRC,  ///< Transform Rotate Clockwise 90 degrees
-    TINV  ///< Transform INVert (pixels inverted)
-  };
+   * End a group of messages.
+   *
+   * Asynchronous implementations should wait for the last message to complete.
+   */
+  virtual void endTransaction(void) {};
 
   /**
-   * Class Constructor - arbitrary digital interface.
+   * Send one message to the devices.
    *
-   * Instantiate a new instance of the class. The parameters passed are used to
-   * connect the software to the hardware. Multiple instances may co-exist
-   * but they should not share the same hardware CS pin (SPI interface).
+   * Select the devices, send size bytes of data and then latch the data
+   * into the devices.
    *
-   * \param mod       module type used in this application. One of the moduleType_t values.
-   * \param dataPin   output on the Arduino where data gets shifted out.
-   * \param clkPin    output for the clock signal.
-   * \param csPin     output for selecting the device.
-   * \param numDevices  number of devices connected. Default is 1 if not supplied.
-   *                    Memory for device buffers is dynamically allocated based
-   *                    on this parameter.
+   * \param data  pointer to the data to send.
+   * \param size  number of bytes to send.
    */
-  MD_MAX72XX(moduleType_t mod, int8_t dataPin, int8_t clkPin, int8_t csPin, uint8_t numDevices=1);
+  virtual void send(const uint8_t *data, uint16_t size) = 0;
 
   /**
-   * Class Constructor - default SPI hardware interface.
-   *
-   * Instantiate a new instance of the class. The parameters passed are used to
-   * connect the software to the hardware. Multiple instances may co-exist
-   * but they should not share the same hardware CS pin (SPI interface).
-   * The dataPin and the clockPin are defined by the Arduino hardware definition
-   * (SPI MOSI and SCK signals).
+   * Check if a message is still being sent.
    *
-   * \param mod     module type used in this application. One of the moduleType_t values.
-   * \param csPin   output for selecting the device.
-   * \param numDevices  number of devices connected. Default is 1 if not supplied.
-   *                    Memory for device buffers is dynamically allocated based
-   *                    on this parameter.
+   * \return true if an asynchronous send() has not completed, false otherwise.
    */
-  MD_MAX72XX(moduleType_t mod, int8_t csPin, uint8_t numDevices=1);
+  virtual bool isBusy(void) { return(false); };
 
   /**
-   * Class Constructor - specify SPI hardware interface.
+   * Select the chain of devices for the next message.
    *
-   * Instantiate a new instance of the class with a specified SPI object. This
-   * allows a specific SPI interface to be specified for architectures with more 
-   * than one hardware SPI interface. 
-   * The parameters passed are used to connect the software to the hardware. 
-   * Multiple instances may co-exist but they should not share the same hardware 
-   * CS pin (SPI interface). The dataPin and the clockPin are defined by the Arduino 
-   * hardware definition for the specified SPI interface (SPI MOSI and SCK signals).
+   * Called before each send() when the devices have been split into separate
+   * chains with MD_MAX72XX::setChains(). The next message is only for the devices
+   * in this chain and the derived class should select them (eg, with a different
+   * CS/LD output or SPI bus).
    *
-   * \param mod     module type used in this application. One of the moduleType_t values.
-   * \param spi     reference to the SPI object to use for comms to the device
-   * \param csPin   output for selecting the device.
-   * \param numDevices  number of devices connected. Default is 1 if not supplied.
-   *                    Memory for device buffers is dynamically allocated based
-   *                    on this parameter.
+   * \param chain  the chain for the next message [0..number of chains-1].
    */
-  MD_MAX72XX(moduleType_t mod, SPIClass &spi, int8_t csPin, uint8_t numDevices = 1);
+  virtual void selectChain(uint8_t chain) { (void)chain; };
 
   /**
-   * Initialize the object.
+   * Set the send complete callback function.
    *
-   * Initialize the object data. This needs to be called during setup() to initialize 
-   * new data for the class that cannot be done during the object creation.
+   * The callback function is invoked by sendComplete() when an asynchronous 
+   * transfer completes. It may be called from an interrupt context.
    *
-   * The LED hardware is initialized to the middle intensity value, all rows showing,
-   * and all LEDs cleared (off). Test, shutdown and decode modes are off. Display updates
-   * are on and wraparound is off.
-   * 
-   * \return true if initialized with no error, false otherwise.
+   * \param cb  the address of the user function to be called, nullptr for none.
    */
-  bool begin(void);
+  void setCompleteCallback(void (*cb)(void)) { _cbComplete = cb; };
 
+protected:
   /**
-   * Class Destructor.
+   * Signal the end of a send.
    *
-   * Released allocated memory and does the necessary to clean up once the object is
-   * no longer required.
+   * Derived classes call this when the data has been sent and latched into the devices.
    */
-  ~MD_MAX72XX();
+  void sendComplete(void) { if (_cbComplete != nullptr) (*_cbComplete)(); };
 
-  //--------------------------------------------------------------
-  /** \name Methods for object and hardware control.
-   * @{
-   */
+private:
+  void (*_cbComplete)(void);  // user callback function for send complete
+};
+
+/**
+ * Communications class that does not need any hardware.
+ *
+ * The messages sent to this object are counted and optionally passed to a
+ * user callback function, allowing the library to be exercised and the amount 
+ * of data sent to be measured on any platform without devices connected.
+ */
+class MD_MAX72XX_MockSPI : public MD_MAX72XX_Transport
+{
+public:
   /**
-   * Set the control status of the specified parameter for the specified device.
-   *
-   * The device has a number of control parameters that can be set through this method.
-   * The type of control action required is passed through the mode parameter and
-   * should be one of the control actions defined by controlRequest_t. The value that
-   * needs to be supplied on the control action required is one of the defined
-   * actions in controlValue_t or a numeric parameter suitable for the control action.
+   * Class Constructor.
    *
-   * \param dev     address of the device to control [0..getDeviceCount()-1].
-   * \param mode    one of the defined control requests.
-   * \param value   parameter value or one of the control status defined.
-   * \return false if parameter errors, true otherwise.
+   * \param cb  the address of a function to receive each message, or nullptr for none.
    */
-  bool control(uint8_t dev, controlRequest_t mode, int value);
+  MD_MAX72XX_MockSPI(void (*cb)(const uint8_t *data, uint16_t size) = nullptr) : _cbSend(cb), _chain(0) { reset(); };
 
   /**
-   * Set the control status of the specified parameter for all devices.
-   *
-   * Invokes the control function for each device in turn. as this is a wrapper for the
-   * control(startDev, endDev, ...) methods, see the documentation for that method.
-   *
-   * \param mode    one of the defined control requests.
-   * \param value   parameter value or one of the control status defined.
+   * Count a transaction.
    */
-  inline void control(controlRequest_t mode, int value) { control(0, getDeviceCount()-1, mode, value); };
+  virtual void beginTransaction(void) { _transactions++; };
 
   /**
-   * Set the control status of the specified parameter for contiguous subset of devices.
-   *
-   * Invokes the control function for each device in turn for the devices in the subset.
-   * See documentation for the control() method.
+   * Remember the chain selected for the next message.
    *
-   * \param startDev  the first device for the control action [0..getDeviceCount()-1]
-   * \param endDev    the last device for the control action [0..getDeviceCount()-1]
-   * \param mode      one of the defined control requests.
-   * \param value     parameter value or one of the control status defined.
-   * \return false if parameter errors, true otherwise.
+   * \param chain  the chain for the next message.
    */
-  bool control(uint8_t startDev, uint8_t endDev, controlRequest_t mode, int value);
+  virtual void selectChain(uint8_t chain) { _chain = chain; };
 
   /**
-   * Gets the number of devices attached to this class instance.
+   * Count a message and pass it to the callback.
    *
-   * \return uint8_t representing the number of devices attached to this object.
+   * \param data  pointer to the data to send.
+   * \param size  number of bytes to send.
    */
-  uint8_t getDeviceCount(void) { return(_maxDevices); };
+  virtual void send(const uint8_t *data, uint16_t size) 
+  { 
+    _messages++; 
+    _bytes += size; 
+    if (_cbSend != nullptr) (*_cbSend)(data, size); 
+    sendComplete(); 
+  };
 
   /**
-   * Gets the maximum number of columns for devices attached to this class instance.
+   * Reset all the counters to zero.
+   */
+  void reset(void) { _transactions = _messages = _bytes = 0; };
+
+  /**
+   * Get the number of transactions since the last reset().
    *
-   * \return uint16_t representing the number of columns.
+   * \return the number of transactions.
    */
-  uint16_t getColumnCount(void) { return(_maxDevices*COL_SIZE); };
+  uint32_t getTransactions(void) { return(_transactions); };
 
   /**
-   * Set the type of hardware module being used.
+   * Get the number of messages since the last reset().
    *
-   * This method changes the type of module being used in the application 
-   * during at run time.
+   * \return the number of messages (device selections).
+   */
+  uint32_t getMessages(void) { return(_messages); };
+
+  /**
+   * Get the number of bytes sent since the last reset().
    *
-   * \param mod module type used in this application; one of the moduleType_t values.
+   * \return the number of bytes.
    */
-  void setModuleType(moduleType_t mod) { setModuleParameters(mod); };
-  
+  uint32_t getBytes(void) { return(_bytes); };
+
   /**
-   * Set the Shift Data In callback function.
+   * Get the chain of devices selected for the last message.
    *
-   * The callback function is called from the library when a transform shift left
-   * or shift right operation is executed and the library needs to obtain data for
-   * the end element of the shift (ie, conceptually this is the new data that is
-   * shifted 'into' the display). The callback function is invoked when
-   * - WRAPAROUND is not active, as the data would automatically supplied within the library.
+   * Useful in the message callback function when the devices are split into
+   * chains with MD_MAX72XX::setChains().
+   *
+   * \return the chain number, 0 if the devices are not split into chains.
+   */
+  uint8_t getChain(void) { return(_chain); };
+
+private:
+  void (*_cbSend)(const uint8_t *data, uint16_t size);  // user callback function
+  uint32_t _transactions; // count of transactions
+  uint32_t _messages;     // count of messages
+  uint32_t _bytes;        // count of bytes
+  uint8_t  _chain;        // chain selected for the last message
+};
+
+#if defined(TEENSYDUINO)
+/**
+ * Asynchronous hardware SPI communications for Teensy.
+ *
+ * Uses the Teensy SPI library DMA transfer with an EventResponder to send
+ * the data in the background. The device select is released and sendComplete()
+ * invoked from the transfer complete event.
+ *
+ * To split the devices into chains with MD_MAX72XX::setChains(), use the
+ * constructor with a CS/LD output for each chain.
+ */
+class MD_MAX72XX_AsyncSPI : public MD_MAX72XX_Transport
+{
+public:
+  /**
+   * Class Constructor.
+   *
+   * \param spi    reference to the SPI object to use for comms to the device
+   * \param csPin  output for selecting the device.
+   */
+  MD_MAX72XX_AsyncSPI(SPIClass &spi, int8_t csPin) : 
+    _spi(spi), _csPin(csPin), _csPins(nullptr), _csCount(0), _busy(false) {};
+
+  /**
+   * Class Constructor - devices split into chains.
+   *
+   * Chain k is selected with csPins[k]. The array must stay valid while the
+   * object is in use and count must be at least the number of chains set
+   * with MD_MAX72XX::setChains().
+   *
+   * \param spi     reference to the SPI object to use for comms to the device
+   * \param csPins  output for selecting each chain of devices [0..count-1].
+   * \param count   the number of outputs in csPins.
+   */
+  MD_MAX72XX_AsyncSPI(SPIClass &spi, const int8_t *csPins, uint8_t count) : 
+    _spi(spi), _csPin(csPins[0]), _csPins(csPins), _csCount(count), _busy(false) {};
+
+  virtual bool begin(void);
+  virtual void beginTransaction(void);
+  virtual void endTransaction(void);
+  virtual void send(const uint8_t *data, uint16_t size);
+  virtual bool isBusy(void) { return(_busy); };
+  virtual void selectChain(uint8_t chain);
+
+private:
+  SPIClass &_spi;       // SPI object to use
+  int8_t   _csPin;      // device select output for the next transfer
+  const int8_t *_csPins;// device select output for each chain, nullptr for one chain
+  uint8_t  _csCount;    // number of outputs in _csPins
+  volatile bool _busy;  // true while a transfer is in progress
+  EventResponder _event;// transfer complete event
+
+  static void eventHandler(EventResponderRef event);  // transfer complete handler
+};
+#endif
+
+#if USE_LOCAL_FONT
+/**
+ * Abstract class for reading font data from any type of storage.
+ *
+ * Font tables are normally stored in PROGMEM and selected with MD_MAX72XX::setFont().
+ * An object derived from this class can be passed to MD_MAX72XX::setFontSource()
+ * instead to read the same font data from RAM, a file on an SD card or flash
+ * file system, or any other storage. The data is the font table in the format
+ * described in \ref pageFontUtility, starting at offset 0.
+ *
+ * The library reads the font data in blocks through a buffer of FONT_READ_AHEAD
+ * bytes. Unless the font is version 3 it also keeps an index with the offset of
+ * every FONT_SOURCE_STEP'th character for each cached font, which uses 4 bytes of
+ * RAM per entry and is limited to FONT_SOURCE_INDEX_MAX entries. Larger fonts
+ * then have the entries further apart. If the index cannot be allocated,
+ * characters are found by reading the font from the start.
+ */
+class MD_MAX72XX_FontSource
+{
+public:
+  /**
+   * Class Destructor.
+   */
+  virtual ~MD_MAX72XX_FontSource(void) {};
+
+  /**
+   * Read a block of font data.
+   *
+   * Copy up to size bytes of the font table, starting at offset, into buf.
+   * Fewer bytes may be returned at the end of the font data.
+   *
+   * \param offset  offset of the first byte from the start of the font table.
+   * \param buf     pointer to the buffer for the data.
+   * \param size    the maximum number of bytes to read.
+   * \return the number of bytes read, 0 if none or an error occurred.
+   */
+  virtual uint16_t read(uint32_t offset, uint8_t *buf, uint16_t size) = 0;
+};
+
+/**
+ * Font source for a font table in memory.
+ *
+ * The font table may be in RAM (eg, loaded at run time) or PROGMEM.
+ */
+class MD_MAX72XX_MemFont : public MD_MAX72XX_FontSource
+{
+public:
+  /**
+   * Class Constructor.
+   *
+   * \param data     pointer to the font table.
+   * \param size     the number of bytes in the font table.
+   * \param progmem  true if the font table is in PROGMEM, false if it is in RAM.
+   */
+  MD_MAX72XX_MemFont(const uint8_t *data, uint32_t size, bool progmem = false) : _data(data), _size(size), _progmem(progmem) {};
+
+  /**
+   * Read a block of font data.
+   *
+   * \param offset  offset of the first byte from the start of the font table.
+   * \param buf     pointer to the buffer for the data.
+   * \param size    the maximum number of bytes to read.
+   * \return the number of bytes read.
+   */
+  virtual uint16_t read(uint32_t offset, uint8_t *buf, uint16_t size)
+  {
+    if (offset >= _size) return(0);
+    if (size > _size - offset) size = _size - offset;
+    for (uint16_t i = 0; i < size; i++)
+      buf[i] = _progmem ? pgm_read_byte(_data + offset + i) : _data[offset + i];
+    return(size);
+  };
+
+private:
+  const uint8_t *_data; // the font table
+  uint32_t _size;       // number of bytes in the font table
+  bool     _progmem;    // the font table is in PROGMEM
+};
+
+/**
+ * Font source for a font table in a file.
+ *
+ * The file holds the bytes of the font table (the same bytes as the font
+ * data array for PROGMEM). The class template works with any file class that
+ * has seek(position) and read(buffer, size) methods, such as the File objects
+ * from the SD, SdFat, LittleFS and SPIFFS libraries. The file must be open for
+ * reading and stay open while the font is in use.
+ *
+ * \tparam F  the file class.
+ */
+template <class F>
+class MD_MAX72XX_FileFont : public MD_MAX72XX_FontSource
+{
+public:
+  /**
+   * Class Constructor.
+   *
+   * \param file  reference to the open font file.
+   */
+  MD_MAX72XX_FileFont(F &file) : _file(file) {};
+
+  /**
+   * Read a block of font data.
+   *
+   * \param offset  offset of the first byte from the start of the file.
+   * \param buf     pointer to the buffer for the data.
+   * \param size    the maximum number of bytes to read.
+   * \return the number of bytes read, 0 if none or an error occurred.
+   */
+  virtual uint16_t read(uint32_t offset, uint8_t *buf, uint16_t size)
+  {
+    if (!_file.seek(offset)) return(0);
+
+    int n = _file.read(buf, size);
+
+    return(n < 0 ? 0 : n);
+  };
+
+private:
+  F &_file;   // the font file
+};
+
+#if USE_STDIO_FONT
+#include <stdio.h>
+
+/**
+ * Font source for a font table in a file opened with the C library.
+ *
+ * The file holds the bytes of the font table, as written by the txt2font
+ * utility. The file must be opened for reading in binary mode and stay open
+ * while the font is in use. Only available if USE_STDIO_FONT is set to 1.
+ */
+class MD_MAX72XX_StdioFont : public MD_MAX72XX_FontSource
+{
+public:
+  /**
+   * Class Constructor.
+   *
+   * \param file  the open font file.
+   */
+  MD_MAX72XX_StdioFont(FILE *file) : _file(file) {};
+
+  /**
+   * Read a block of font data.
+   *
+   * \param offset  offset of the first byte from the start of the file.
+   * \param buf     pointer to the buffer for the data.
+   * \param size    the maximum number of bytes to read.
+   * \return the number of bytes read, 0 if none or an error occurred.
+   */
+  virtual uint16_t read(uint32_t offset, uint8_t *buf, uint16_t size)
+  {
+    if ((_file == nullptr) || (fseek(_file, offset, SEEK_SET) != 0)) return(0);
+
+    return(fread(buf, 1, size, _file));
+  };
+
+private:
+  FILE *_file;  // the font file
+};
+#endif
+#endif
+
+/**
+ * Core object for the MD_MAX72XX library
+ */
+class MD_MAX72XX
+{
+public:
+  /**
+  * Module Type enumerated type.
+  *
+  * This enumerated type is used to defined the type of
+  * modules being used in the application. The types of modules are
+  * discussed in detail in the Hardware section of this documentation.
+  * For structured name types see \ref pageNewHardware.
+  * Short Form: DR - Digits as rows; CR - Columns Reversed; RR - Rows Reversed
+  */
+  enum moduleType_t
+  {
+    GENERIC_HW,   ///< Use 'generic' style hardware modules commonly available.
+    FC16_HW,      ///< Use FC-16 style hardware module.
+    PAROLA_HW,    ///< Use the Parola style hardware modules.
+    ICSTATION_HW, ///< Use ICStation style hardware module.
+
+    DR0CR0RR0_HW, ///< Structured name
+    DR0CR0RR1_HW, ///< Structured name
+    DR0CR1RR0_HW, ///< Structured name; equivalent to GENERIC_HW
+    DR0CR1RR1_HW, ///< Structured name
+    DR1CR0RR0_HW, ///< Structured name; equivalent to FC16_HW
+    DR1CR0RR1_HW, ///< Structured name
+    DR1CR1RR0_HW, ///< Structured name; equivalent to PAROLA_HW
+    DR1CR1RR1_HW  ///< Structured name; equivalent to ICSTATION_HW
+  };
+
+#if USE_LOCAL_FONT
+  /**
+  * Font definition type.
+  *
+  * This type is used in the setFont() method to set the font to be used
+  */
+  typedef  const uint8_t fontType_t;
+
+  /**
+  * Font properties structure.
+  *
+  * This structure holds the properties of a font table. They are worked out
+  * in one pass over the font table the first time the font is selected with
+  * setFont() and are returned by getFontInfo().
+  */
+  typedef struct
+  {
+    uint8_t  version;     ///< font definition file format version
+    uint8_t  height;      ///< font height in pixels
+    uint8_t  widthMax;    ///< width in pixels of the widest character
+    uint8_t  widthMin;    ///< width in pixels of the narrowest character with at least one column
+    uint16_t firstASCII;  ///< the first character code in the font table
+    uint16_t lastASCII;   ///< the last character code in the font table
+    uint16_t dataOffset;  ///< offset from the start of table to first character definition
+    uint16_t rangeCount;  ///< number of ranges of character codes in a version 3 font table, 0 otherwise
+    uint16_t dirOffset;   ///< offset from the start of table to the character directory of a version 3 font table
+    uint16_t charCount;   ///< number of characters with at least one column
+    uint32_t dataSize;    ///< total size of the font table in bytes
+    uint8_t  flags;       ///< bit field of fontFlag_t values
+  } fontInfo_t;
+
+  /**
+  * Font flags enumerated type.
+  *
+  * This enumerated type defines the bits set in the flags field of fontInfo_t.
+  */
+  enum fontFlag_t
+  {
+    FONT_FIXED_WIDTH = 0x01,  ///< All characters with at least one column are the same width.
+    FONT_EMPTY_CHARS = 0x02,  ///< The font table includes characters with no columns.
+    FONT_UNKNOWN_VER = 0x04,  ///< The header version is not known to the library and defaults were used.
+    FONT_INDEXED     = 0x08   ///< The character index is available for this font (see USE_FONT_INDEX).
+  };
+
+  /**
+  * Character cache statistics structure.
+  *
+  * This structure holds the number of character lookups found in the character
+  * cache (see GLYPH_CACHE_SIZE) and the number read from the font table since
+  * the statistics were last reset, returned by getGlyphCacheStats().
+  */
+  typedef struct
+  {
+    uint32_t hits;    ///< characters found in the cache
+    uint32_t misses;  ///< characters read from the font table
+  } glyphCacheStats_t;
+
+  /**
+  * Kerning pair structure.
+  *
+  * This structure defines a change to the spacing between two characters
+  * in the text rendered by renderText(). An array of these is set with setKerning().
+  */
+  typedef struct
+  {
+    uint16_t first;   ///< character on the left
+    uint16_t second;  ///< character on the right
+    int8_t   adjust;  ///< columns added to the character spacing, negative to move the characters closer
+  } kernPair_t;
+#endif
+
+  /**
+  * Control Request enumerated type.
+  *
+  * This enumerated type is used with the control() method to identify
+  * the control action request.
+  */
+  enum controlRequest_t
+  {
+    SHUTDOWN = 0,   ///< Shut down the MAX72XX. Requires ON/OFF value. Library default is OFF.
+    SCANLIMIT = 1,  ///< Set the scan limit for the MAX72XX. Requires numeric value [0..MAX_SCANLIMIT]. Library default is all on.
+    INTENSITY = 2,  ///< Set the LED intensity for the MAX72XX. Requires numeric value [0..MAX_INTENSITY]. LIbrary default is MAX_INTENSITY/2.
+    TEST = 3,       ///< Set the MAX72XX in test mode. Requires ON/OFF value. Library default is OFF.
+    DECODE = 4,     ///< Set the MAX72XX 7 segment decode mode. Requires ON/OFF value. Library default is OFF.
+    UPDATE = 10,    ///< Enable or disable auto updates of the devices from the library. Requires ON/OFF value. Library default is ON.
+    WRAPAROUND = 11,///< Enable or disable wraparound when shifting (circular buffer). Requires ON/OFF value. Library default is OFF.
+    BURST = 12      ///< Enable or disable sending all changed rows in one SPI transaction when all devices are updated. Requires ON/OFF value. Library default is OFF.
+  };
+
+  /**
+  * Control Value enumerated type.
+  *
+  * This enumerated type is used with the control() method as the
+  * ON/OFF value for a control request. Other values may be used
+  * if numeric data is required.
+  */
+  enum controlValue_t
+  {
+    OFF = 0,  ///< General OFF status request
+    ON = 1    ///< General ON status request
+  };
+
+  /**
+   * Transformation Types enumerated type.
+  *
+  * This enumerated type is used in the transform() methods to identify a
+  * specific transformation of the display data in the device buffers.
+  */
+  enum transformType_t
+  {
+    TSL,  ///< Transform Shift Left one pixel element
+    TSR,  ///< Transform Shift Right one pixel element
+    TSU,  ///< Transform Shift Up one pixel element
+    TSD,  ///< Transform Shift Down one pixel element
+    TFLR, ///< Transform Flip Left to Right
+    TFUD, ///< Transform Flip Up to Down
+    TRC,  ///< Transform Rotate Clockwise 90 degrees
+    TINV  ///< Transform INVert (pixels inverted)
+  };
+
+  /**
+  * Raster Operation enumerated type.
+  *
+  * This enumerated type is used in the blit() method to define how the
+  * bitmap pixels are combined with the pixels already on the display.
+  */
+  enum rasterOp_t
+  {
+    ROP_COPY, ///< Replace the display pixels with the bitmap pixels
+    ROP_OR,   ///< Turn on the display pixels that are on in the bitmap (transparent background)
+    ROP_AND,  ///< Turn off the display pixels that are off in the bitmap
+    ROP_XOR   ///< Invert the display pixels that are on in the bitmap
+  };
+
+  /**
+  * Tile Wiring enumerated type.
+  *
+  * This enumerated type is used in setGeometry() to define how the chain of
+  * devices runs through the rows of tiles in a 2D display. Device 0 is always
+  * the top right tile and the chain runs from right to left along the top row.
+  */
+  enum tileWiring_t
+  {
+    TILE_ZIGZAG,    ///< Every row of tiles runs from right to left
+    TILE_SERPENTINE ///< Rows of tiles alternate direction, the second row runs from left to right
+  };
+
+  /**
+  * Tile Rotation enumerated type.
+  *
+  * This enumerated type is used in setGeometry() to define how each device
+  * is mounted in a 2D display, as a clockwise rotation from the normal orientation.
+  */
+  enum tileRotation_t
+  {
+    ROT_0,    ///< Normal orientation
+    ROT_90,   ///< Rotated 90 degrees clockwise
+    ROT_180,  ///< Rotated 180 degrees (upside down)
+    ROT_270   ///< Rotated 270 degrees clockwise (90 degrees anticlockwise)
+  };
+
+  /**
+  * Update statistics structure.
+  *
+  * This structure holds the amount of communications used by the last update
+  * of the devices, returned by getUpdateStats(). The values are reset at the start
+  * of every update of the display and each control() request sent to the devices.
+  */
+  typedef struct
+  {
+    uint32_t bytes;         ///< number of bytes sent to the devices
+    uint16_t csPulses;      ///< number of times the devices were selected (CS/LD pulses)
+    uint16_t transactions;  ///< number of SPI transactions (hardware SPI settings applied)
+  } updateStats_t;
+
+  /**
+  * Pending changes structure.
+  *
+  * This structure describes the changes in the display buffers that have not yet
+  * been sent to the devices, returned by getDirtyInfo(). The projected cost is for
+  * sending all the changes with update() using the current BURST setting.
+  */
+  typedef struct
+  {
+    uint16_t devices;       ///< number of devices with changes to send
+    uint16_t digits;        ///< total number of device digits to send
+    uint8_t  rows;          ///< digit rows with changes in any device, one bit per digit
+    uint32_t bytes;         ///< projected number of bytes sent to the devices
+    uint16_t transactions;  ///< projected number of SPI transactions
+  } dirtyInfo_t;
+
+#if !HOST_BUILD_ACTIVE
+  /**
+   * Class Constructor - arbitrary digital interface.
+   *
+   * Instantiate a new instance of the class. The parameters passed are used to
+   * connect the software to the hardware. Multiple instances may co-exist
+   * but they should not share the same hardware CS pin (SPI interface).
+   *
+   * \param mod       module type used in this application. One of the moduleType_t values.
+   * \param dataPin   output on the Arduino where data gets shifted out.
+   * \param clkPin    output for the clock signal.
+   * \param csPin     output for selecting the device.
+   * \param numDevices  number of devices connected. Default is 1 if not supplied.
+   *                    Memory for device buffers is dynamically allocated based
+   *                    on this parameter.
+   */
+  MD_MAX72XX(moduleType_t mod, int8_t dataPin, int8_t clkPin, int8_t csPin, uint8_t numDevices=1);
+
+  /**
+   * Class Constructor - default SPI hardware interface.
+   *
+   * Instantiate a new instance of the class. The parameters passed are used to
+   * connect the software to the hardware. Multiple instances may co-exist
+   * but they should not share the same hardware CS pin (SPI interface).
+   * The dataPin and the clockPin are defined by the Arduino hardware definition
+   * (SPI MOSI and SCK signals).
+   *
+   * \param mod     module type used in this application. One of the moduleType_t values.
+   * \param csPin   output for selecting the device.
+   * \param numDevices  number of devices connected. Default is 1 if not supplied.
+   *                    Memory for device buffers is dynamically allocated based
+   *                    on this parameter.
+   */
+  MD_MAX72XX(moduleType_t mod, int8_t csPin, uint8_t numDevices=1);
+
+  /**
+   * Class Constructor - specify SPI hardware interface.
+   *
+   * Instantiate a new instance of the class with a specified SPI object. This
+   * allows a specific SPI interface to be specified for architectures with more 
+   * than one hardware SPI interface. 
+   * The parameters passed are used to connect the software to the hardware. 
+   * Multiple instances may co-exist but they should not share the same hardware 
+   * CS pin (SPI interface). The dataPin and the clockPin are defined by the Arduino 
+   * hardware definition for the specified SPI interface (SPI MOSI and SCK signals).
+   *
+   * \param mod     module type used in this application. One of the moduleType_t values.
+   * \param spi     reference to the SPI object to use for comms to the device
+   * \param csPin   output for selecting the device.
+   * \param numDevices  number of devices connected. Default is 1 if not supplied.
+   *                    Memory for device buffers is dynamically allocated based
+   *                    on this parameter.
+   */
+  MD_MAX72XX(moduleType_t mod, SPIClass &spi, int8_t csPin, uint8_t numDevices = 1);
+
+#endif
+
+  /**
+   * Class Constructor - alternative communications interface.
+   *
+   * Instantiate a new instance of the class that uses an object derived from
+   * MD_MAX72XX_Transport for all communications with the devices. The 
+   * transport object is responsible for all the hardware interface, including
+   * device selection, and must exist for the life of this object.
+   *
+   * \param mod       module type used in this application. One of the moduleType_t values.
+   * \param transport reference to the communications object.
+   * \param numDevices  number of devices connected. Default is 1 if not supplied.
+   *                    Memory for device buffers is dynamically allocated based
+   *                    on this parameter.
+   */
+  MD_MAX72XX(moduleType_t mod, MD_MAX72XX_Transport &transport, uint8_t numDevices = 1);
+
+  /**
+   * Initialize the object.
+   *
+   * Initialize the object data. This needs to be called during setup() to initialize 
+   * new data for the class that cannot be done during the object creation.
+   *
+   * The LED hardware is initialized to the middle intensity value, all rows showing,
+   * and all LEDs cleared (off). Test, shutdown and decode modes are off. Display updates
+   * are on and wraparound is off.
+   * 
+   * \return true if initialized with no error, false otherwise.
+   */
+  bool begin(void);
+
+  /**
+   * Class Destructor.
+   *
+   * Released allocated memory and does the necessary to clean up once the object is
+   * no longer required.
+   */
+  ~MD_MAX72XX();
+
+  //--------------------------------------------------------------
+  /** \name Methods for object and hardware control.
+   * @{
+   */
+  /**
+   * Set the control status of the specified parameter for the specified device.
+   *
+   * The device has a number of control parameters that can be set through this method.
+   * The type of control action required is passed through the mode parameter and
+   * should be one of the control actions defined by controlRequest_t. The value that
+   * needs to be supplied on the control action required is one of the defined
+   * actions in controlValue_t or a numeric parameter suitable for the control action.
+   *
+   * \param dev     address of the device to control [0..getDeviceCount()-1].
+   * \param mode    one of the defined control requests.
+   * \param value   parameter value or one of the control status defined.
+   * \return false if parameter errors, true otherwise.
+   */
+  bool control(uint8_t dev, controlRequest_t mode, int value);
+
+  /**
+   * Set the control status of the specified parameter for all devices.
+   *
+   * Invokes the control function for each device in turn. as this is a wrapper for the
+   * control(startDev, endDev, ...) methods, see the documentation for that method.
+   *
+   * \param mode    one of the defined control requests.
+   * \param value   parameter value or one of the control status defined.
+   */
+  inline void control(controlRequest_t mode, int value) { control(0, getDeviceCount()-1, mode, value); };
+
+  /**
+   * Set the control status of the specified parameter for contiguous subset of devices.
+   *
+   * Invokes the control function for each device in turn for the devices in the subset.
+   * See documentation for the control() method.
+   *
+   * \param startDev  the first device for the control action [0..getDeviceCount()-1]
+   * \param endDev    the last device for the control action [0..getDeviceCount()-1]
+   * \param mode      one of the defined control requests.
+   * \param value     parameter value or one of the control status defined.
+   * \return false if parameter errors, true otherwise.
+   */
+  bool control(uint8_t startDev, uint8_t endDev, controlRequest_t mode, int value);
+
+  /**
+   * Gets the number of devices attached to this class instance.
+   *
+   * \return uint8_t representing the number of devices attached to this object.
+   */
+  uint8_t getDeviceCount(void) { return(_maxDevices); };
+
+  /**
+   * Gets the maximum number of columns for devices attached to this class instance.
+   *
+   * \return uint16_t representing the number of columns.
+   */
+  uint16_t getColumnCount(void) { return(_maxDevices*COL_SIZE); };
+
+  /**
+   * Set the type of hardware module being used.
+   *
+   * This method changes the type of module being used in the application 
+   * during at run time. If USE_CANONICAL_BUFFER is enabled the current display
+   * data is kept and is sent in the new module layout at the next update.
+   *
+   * The module type of an MD_MAX72XX_T object is fixed at compile time and this
+   * method does nothing, even when called through a reference to MD_MAX72XX.
+   *
+   * \param mod module type used in this application; one of the moduleType_t values.
+   */
+  void setModuleType(moduleType_t mod) { if (!_modFixed) setModuleParameters(mod); };
+
+  /**
+   * Split the devices into separate chains.
+   *
+   * Long displays can be wired as several shorter chains of devices, each with
+   * its own CS/LD output, sharing the SPI data and clock signals. The devices
+   * keep the same numbering (and the display the same columns) as a single
+   * chain: chain 0 has the first devices[0] devices, chain 1 the next devices[1]
+   * devices, and so on. In each chain the first device is the one connected to
+   * the processor. Data is only sent to the chains that have changes, so updates
+   * that only change part of the display send much less data.
+   *
+   * When a MD_MAX72XX_Transport object is used, the csPins are not used (and may
+   * be nullptr) and the object's selectChain() method is called before each
+   * message instead. The transport must implement selectChain(), otherwise all the
+   * chains are sent on the same output. MD_MAX72XX_AsyncSPI needs the constructor
+   * with a CS/LD output for each chain. On MBED only the transport object can be
+   * used with chains.
+   *
+   * \param count   the number of chains, 0 for a single chain using the constructor CS pin.
+   * \param csPins  the CS/LD output for each chain [0..count-1].
+   * \param devices the number of devices in each chain [0..count-1]. The total must be getDeviceCount().
+   * \return false if parameter errors or memory could not be allocated, true otherwise.
+   */
+  bool setChains(uint8_t count, const int8_t *csPins, const uint8_t *devices);
+  
+  /**
+   * Set the Shift Data In callback function.
+   *
+   * The callback function is called from the library when a transform shift left
+   * or shift right operation is executed and the library needs to obtain data for
+   * the end element of the shift (ie, conceptually this is the new data that is
+   * shifted 'into' the display). The callback function is invoked when
+   * - WRAPAROUND is not active, as the data would automatically supplied within the library.
    * - the call to transform() is global (ie, not for an individual buffer).
    *
    * The callback function takes 2 parameters:
@@ -700,6 +1504,172 @@ public:
    */
   bool setBuffer(uint16_t col, uint8_t size, uint8_t *pd);
 
+  /**
+   * Draw a bitmap on the display, clipped to the display edges.
+   *
+   * The bitmap is defined in the same way as setBuffer() and the font characters:
+   * one byte for each column, the first byte is the leftmost column (drawn at
+   * column x) and the following bytes are drawn at x-1, x-2, etc. The least
+   * significant bit of each byte is the top row of the bitmap, drawn at row y.
+   *
+   * Parts of the bitmap outside the display are ignored, so x and y may be
+   * negative or past the display edges (eg, for sprites moving on or off the display).
+   * The bitmap is combined with the display pixels as specified by the raster
+   * operation, only within the w x h rectangle. The data is written directly to
+   * the device buffers and only the digits that have changed are sent to the
+   * devices, once at the end of the method if auto updates are on.
+   *
+   * \param x      display column for the first bitmap column (may be off the display).
+   * \param y      display row for the top row of the bitmap (may be off the display).
+   * \param w      width of the bitmap in columns (number of bytes in the bitmap).
+   * \param h      height of the bitmap in rows [1..ROW_SIZE].
+   * \param bitmap pointer to the bitmap data in RAM [0..w-1].
+   * \param rop    how the bitmap is combined with the display; one of the rasterOp_t values.
+   * \return false if parameter errors, true otherwise.
+   */
+  bool blit(int16_t x, int8_t y, uint8_t w, uint8_t h, const uint8_t *bitmap, rasterOp_t rop = ROP_COPY);
+
+  /**
+   * Set the virtual canvas shown through the viewport.
+   *
+   * The canvas is a bitmap that can be much wider than the display (eg, a
+   * message rendered once into RAM or stored in PROGMEM), defined in the same
+   * way as for blit(): one byte for each column, the first byte is the leftmost
+   * column and the least significant bit is the top row. The canvas data is
+   * not copied, so it must remain valid while it is in use. Nothing is drawn
+   * until setViewport() is called.
+   *
+   * \param data     pointer to the canvas data [0..width-1], nullptr to remove the canvas.
+   * \param width    width of the canvas in columns.
+   * \param progmem  true if the data is in PROGMEM, false if it is in RAM.
+   * \return false if parameter errors, true otherwise.
+   */
+  bool setCanvas(const uint8_t *data, uint16_t width, bool progmem = false);
+
+  /**
+   * Set the display columns used to show the canvas.
+   *
+   * By default the canvas is shown on the whole display. The window can be
+   * any range of columns, including part of a device, and the display columns
+   * outside the window are not changed by setViewport().
+   *
+   * \param colStart  the lowest (rightmost) display column of the window [0..getColumnCount()-1].
+   * \param colEnd    the highest (leftmost) display column of the window [colStart..getColumnCount()-1].
+   * \return false if parameter errors, true otherwise.
+   */
+  bool setCanvasWindow(uint16_t colStart, uint16_t colEnd);
+
+  /**
+   * Show the canvas starting at a column offset.
+   *
+   * The canvas column offset is drawn in the leftmost column of the window and
+   * the following canvas columns to its right. Columns outside the canvas are off
+   * unless wraparound is on, when the canvas repeats end to end. The offset may be
+   * negative (eg, so a message scrolls in from the right). Only the digits that
+   * have changed are sent to the devices, once if auto updates are on, so scrolling
+   * the canvas is just a change of offset:
+   *
+   *     mx.setViewport(mx.getViewport() + 1); // scroll left one column
+   *
+   * \param offset  canvas column shown in the leftmost column of the window.
+   * \return false if no canvas is set, true otherwise.
+   */
+  bool setViewport(int16_t offset);
+
+  /**
+   * Get the current viewport offset.
+   *
+   * \return the canvas column shown in the leftmost column of the window, see setViewport().
+   */
+  int16_t getViewport(void) { return(_canvas.offset); };
+
+  /**
+   * Draw a straight line between two points.
+   *
+   * The line is drawn using Bresenham's algorithm. The end points may be off
+   * the display, in which case only the part of the line on the display is drawn.
+   * All the pixels are written to the device buffers before any data is sent, so
+   * the line is sent to the devices only once if auto updates are on.
+   *
+   * \param r1    row for the start of the line.
+   * \param c1    column for the start of the line.
+   * \param r2    row for the end of the line.
+   * \param c2    column for the end of the line.
+   * \param state true - switch the LEDs on; false - switch them off.
+   */
+  void drawLine(int8_t r1, int16_t c1, int8_t r2, int16_t c2, bool state = true);
+
+  /**
+   * Draw the outline of a rectangle.
+   *
+   * The rectangle is defined by two opposite corners, which may be off the display.
+   * Only the part of the rectangle on the display is drawn and the changes are
+   * sent to the devices once if auto updates are on.
+   *
+   * \param r1    row for the first corner.
+   * \param c1    column for the first corner.
+   * \param r2    row for the opposite corner.
+   * \param c2    column for the opposite corner.
+   * \param state true - switch the LEDs on; false - switch them off.
+   */
+  void drawRect(int8_t r1, int16_t c1, int8_t r2, int16_t c2, bool state = true);
+
+  /**
+   * Draw a filled rectangle.
+   *
+   * As for drawRect(), but all the LEDs inside the rectangle are also set.
+   * Each column of the rectangle is written as one span of rows.
+   *
+   * \param r1    row for the first corner.
+   * \param c1    column for the first corner.
+   * \param r2    row for the opposite corner.
+   * \param c2    column for the opposite corner.
+   * \param state true - switch the LEDs on; false - switch them off.
+   */
+  void fillRect(int8_t r1, int16_t c1, int8_t r2, int16_t c2, bool state = true);
+
+  /**
+   * Draw the outline of a circle.
+   *
+   * The circle is drawn using the midpoint circle algorithm. The center may be
+   * off the display and only the part of the circle on the display is drawn.
+   * The changes are sent to the devices once if auto updates are on.
+   *
+   * \param r      row for the center of the circle.
+   * \param c      column for the center of the circle.
+   * \param radius radius of the circle in pixels.
+   * \param state  true - switch the LEDs on; false - switch them off.
+   */
+  void drawCircle(int8_t r, int16_t c, uint8_t radius, bool state = true) { circle(r, c, radius, state, false); };
+
+  /**
+   * Draw a filled circle.
+   *
+   * As for drawCircle(), but all the LEDs inside the circle are also set.
+   *
+   * \param r      row for the center of the circle.
+   * \param c      column for the center of the circle.
+   * \param radius radius of the circle in pixels.
+   * \param state  true - switch the LEDs on; false - switch them off.
+   */
+  void fillCircle(int8_t r, int16_t c, uint8_t radius, bool state = true) { circle(r, c, radius, state, true); };
+
+  /**
+   * Fill an area of the display.
+   *
+   * All the LEDs connected horizontally or vertically to the starting point
+   * that are not already in the new state are set to the new state. The area
+   * is worked out a column at a time in a temporary buffer of getColumnCount()
+   * bytes allocated for the call, then the changes are sent to the devices
+   * once if auto updates are on.
+   *
+   * \param r     row for the starting point [0..ROW_SIZE-1].
+   * \param c     column for the starting point [0..getColumnCount()-1].
+   * \param state true - switch the LEDs on; false - switch them off.
+   * \return false if parameter errors or the buffer could not be allocated, true otherwise.
+   */
+  bool floodFill(uint8_t r, uint16_t c, bool state = true);
+
   /**
    * Set all LEDs in a specific column to a new state.
    *
@@ -813,17 +1783,250 @@ public:
   void update(void) { flushBufferAll(); };
 
   /**
-   * Turn display wraparound on or off.
-   *
-   * When shifting left or right, up or down, the outermost edge is normally lost and a blank
-   * row or column inserted on the opposite side. If this options is enabled, the edge is wrapped
-   * around to the opposite side.
+   * Turn display wraparound on or off.
+   *
+   * When shifting left or right, up or down, the outermost edge is normally lost and a blank
+   * row or column inserted on the opposite side. If this options is enabled, the edge is wrapped
+   * around to the opposite side.
+   *
+   * This function is a convenience wrapper for the more general control() function call.
+   *
+   * \param mode  one of the types in controlValue_t (ON/OFF).
+   */
+  void wraparound(controlValue_t mode) { control(WRAPAROUND, mode); };
+
+  /**
+   * Get the communications statistics for the last update.
+   *
+   * Returns the number of bytes, device selections (CS pulses) and SPI transactions
+   * used by the last update of the devices or control() request. This is useful to
+   * measure the effect of options such as BURST on long chains of devices.
+   *
+   * \return reference to the update statistics structure.
+   */
+  const updateStats_t& getUpdateStats(void) { return(_updateStats); };
+
+  /**
+   * Get the changes waiting to be sent to the devices.
+   *
+   * Reports the devices and digits in the display buffers that have changed since
+   * they were last sent, and the bytes and SPI transactions that update() would use
+   * to send them. This allows an application to decide whether there is time for
+   * an update before starting it, or to use updatePartial() instead.
+   *
+   * \param info  structure to be filled in with the pending changes.
+   * \return true if there are changes waiting to be sent, false otherwise.
+   */
+  bool getDirtyInfo(dirtyInfo_t &info);
+
+  /**
+   * Get the changed digits of one device.
+   *
+   * Returns the device digits that have changed since they were last sent,
+   * one bit per digit (bit 0 is digit 0 in the device).
+   *
+   * \param buf   address of the device [0..getDeviceCount()-1].
+   * \return the changed digits bit field, 0 if none or buf is invalid.
+   */
+  uint8_t getChangedDigits(uint8_t buf);
+
+  /**
+   * Send part of the buffered changes to the devices.
+   *
+   * Changes are sent in the same way as update(), one digit row for all the devices
+   * at a time, but the update stops before it uses more than maxBytes. The remaining
+   * changes are sent by the next call to this method or update(). Calling this
+   * method regularly (eg, from loop()) spreads the time taken by a large update
+   * over a number of calls. Each digit row uses 2 bytes for every device (or for
+   * every device in the chains with changes, see setChains()). At least one digit row
+   * with changes is sent by each call, even if it uses more than maxBytes.
+   *
+   * \param maxBytes  the maximum number of bytes to send to the devices.
+   * \return true if there are still changes waiting to be sent, false otherwise.
+   */
+  bool updatePartial(uint32_t maxBytes);
+
+  /**
+   * Set the limits for each part of a time sliced frame update.
+   *
+   * Each call to serviceFrame() sends digit rows until the next row would take
+   * it past either of these limits. At least one digit row is always sent, so
+   * a frame update finishes even if the limits are too small for a whole row.
+   * Each digit row is 2 bytes for every device in the chains with changes.
+   *
+   * \param maxBytes   the maximum number of bytes sent by each call, 0 for no limit.
+   * \param maxMicros  the maximum time for each call in microseconds, 0 for no limit.
+   */
+  void setFrameSlice(uint16_t maxBytes, uint16_t maxMicros) { _sliceBytes = maxBytes; _sliceMicros = maxMicros; };
+
+  /**
+   * Start a time sliced update of the current display buffers.
+   *
+   * All the buffered changes are copied as one frame, to be sent to the devices by
+   * later calls to serviceFrame(). The application can carry on drawing the next frame
+   * while this frame is being sent, without any of the new changes mixed into the
+   * frame being sent. The new changes are sent by the next frame or update.
+   *
+   * Auto updates should be turned off when this is used. Any other method that
+   * sends data to the devices will finish sending the frame first. The copy of
+   * the display buffers is allocated on the first call to this method.
+   *
+   * \return false if the previous frame has not been sent or memory could not be allocated, true otherwise.
+   */
+  bool commitFrame(void);
+
+  /**
+   * Send the next part of a frame started by commitFrame().
+   *
+   * This method must be called regularly (eg, from loop()) after commitFrame() to
+   * send the frame to the devices in slices limited by setFrameSlice(). When the
+   * whole frame has been sent the update callback function, if set, is invoked.
+   * The statistics returned by getUpdateStats() are for the whole frame.
+   *
+   * \return true if there is still frame data to send, false otherwise.
+   */
+  bool serviceFrame(void);
+
+  /**
+   * Start an update of all devices without waiting for it to finish.
+   *
+   * Starts sending all buffered changes to the devices and returns immediately.
+   * The update proceeds each time isBusy() is called, so isBusy() must be called
+   * regularly until it returns false. Drawing in the display buffers may continue
+   * while the update is in progress; changes made to rows that have already been
+   * sent are kept for the next update.
+   *
+   * With an asynchronous MD_MAX72XX_Transport (eg, DMA) the data for the next row 
+   * is prepared while the previous one is being sent, using a second SPI data buffer 
+   * allocated on the first call to this method. Other communications interfaces send 
+   * one row for each call to isBusy(). The SPI transaction is held until the update 
+   * is finished.
+   *
+   * Any other method that sends data to the devices will wait for the update to
+   * finish first.
+   *
+   * \return false if an update is already in progress or memory could not be allocated, true otherwise.
+   */
+  bool updateAsync(void);
+
+  /**
+   * Check and progress an update started by updateAsync().
+   *
+   * This method must be called regularly after updateAsync() to send the data to
+   * the devices. When the update is finished the update callback function, if set, 
+   * is invoked.
+   *
+   * \return true if the update is still in progress, false otherwise.
+   */
+  bool isBusy(void);
+
+  /**
+   * Set the update complete callback function.
+   *
+   * The callback function is invoked from isBusy() when an update started by 
+   * updateAsync() has finished sending all the data to the devices.
+   *
+   * \param cb  the address of the user function to be called from the library, nullptr for none.
+   */
+  void setUpdateCallback(void (*cb)(void)) { _cbUpdate = cb; };
+  /** @} */
+
+  //--------------------------------------------------------------
+  /** \name Methods for 2D tiled displays.
+   * @{
+   */
+  /**
+   * Set the geometry of a 2D display made up of rows of tiles.
+   *
+   * The devices are arranged as tileRows rows of tileCols tiles, wired as defined
+   * by the wiring parameter, and each device can be mounted in a different orientation.
+   * The mapping of the display to the devices is worked out once here and held in a
+   * lookup table of 2 bytes per device. The display is then addressed with x and y
+   * coordinates, with the origin (0, 0) at the top left corner, using setPixel(),
+   * getPixel() and transform2D(). All the other methods still work on the devices
+   * as one row of getColumnCount() columns.
+   *
+   * \param tileCols  number of tiles in each row of the display.
+   * \param tileRows  number of rows of tiles. tileCols * tileRows must be the number of devices. 0 removes the geometry.
+   * \param wiring    how the chain of devices runs through the rows, one of the tileWiring_t values.
+   * \param rotation  array of getDeviceCount() tileRotation_t values in device order, nullptr if all are ROT_0.
+   * \return false if parameter errors or the table could not be allocated, true otherwise.
+   */
+  bool setGeometry(uint8_t tileCols, uint8_t tileRows, tileWiring_t wiring = TILE_ZIGZAG, const tileRotation_t *rotation = nullptr);
+
+  /**
+   * Get the width of the 2D display.
+   *
+   * \return the number of pixels in each row of the display set by setGeometry(), 0 if not set.
+   */
+  uint16_t getWidth(void) { return(_tileCols * COL_SIZE); };
+
+  /**
+   * Get the height of the 2D display.
+   *
+   * \return the number of pixels in each column of the display set by setGeometry(), 0 if not set.
+   */
+  uint16_t getHeight(void) { return(_tileRows * ROW_SIZE); };
+
+  /**
+   * Set the status of a single LED in the 2D display.
+   *
+   * The pixel is mapped to the device, row and column using the table built by
+   * setGeometry() and set as for setPoint().
+   *
+   * \param x     column from the left of the display [0..getWidth()-1].
+   * \param y     row from the top of the display [0..getHeight()-1].
+   * \param state true - switch on; false - switch off.
+   * \return false if parameter errors or no geometry is set, true otherwise.
+   */
+  bool setPixel(uint16_t x, uint16_t y, bool state);
+
+  /**
+   * Get the status of a single LED in the 2D display.
+   *
+   * \param x     column from the left of the display [0..getWidth()-1].
+   * \param y     row from the top of the display [0..getHeight()-1].
+   * \return true if LED is on, false if off or parameter errors.
+   */
+  bool getPixel(uint16_t x, uint16_t y);
+
+  /**
+   * Apply a transformation to the whole 2D display.
    *
-   * This function is a convenience wrapper for the more general control() function call.
+   * The display set by setGeometry() is transformed as one pixel field, so pixels
+   * shifted off one tile are carried into the next one. Pixels shifted off the
+   * edges of the display are lost unless wraparound is on. The shifts work as for
+   * shift2D(), including the shift callbacks. TRC is not supported.
+   * The changes are sent to the devices once if auto updates are on.
    *
-   * \param mode  one of the types in controlValue_t (ON/OFF).
+   * \param ttype  one of the transformation types in transformType_t.
+   * \return false if parameter errors or no geometry is set, true otherwise.
    */
-  void wraparound(controlValue_t mode) { control(WRAPAROUND, mode); };
+  bool transform2D(transformType_t ttype);
+
+  /**
+   * Shift the whole 2D display one pixel horizontally, vertically or diagonally.
+   *
+   * The pixels shifted off each tile are carried into the next tile, across the
+   * rows and the columns of tiles. The tile digits are moved as whole bytes and
+   * the changes are sent to the devices once if auto updates are on.
+   *
+   * At the edges of the display the pixels shifted off are lost and the pixels
+   * shifted in are off, unless wraparound is on. Otherwise the shift callbacks, if
+   * set, are invoked with the device of the tile at the edge and the TSL, TSR, TSU
+   * or TSD transformation type:
+   * - for horizontal shifts, once for each row of tiles with the column data,
+   *   the least significant bit at the top.
+   * - for vertical shifts, once for each column of tiles with the row data,
+   *   the least significant bit on the left.
+   *
+   * A diagonal shift is done as the horizontal shift followed by the vertical shift.
+   *
+   * \param dx  -1 to shift left, 1 to shift right, 0 for no horizontal shift.
+   * \param dy  -1 to shift up, 1 to shift down, 0 for no vertical shift.
+   * \return false if parameter errors or no geometry is set, true otherwise.
+   */
+  bool shift2D(int8_t dx, int8_t dy);
   /** @} */
 
   //--------------------------------------------------------------
@@ -955,6 +2158,148 @@ public:
    */
   uint8_t setChar(uint16_t col, uint16_t c);
 
+  /**
+   * Render a text string into a column buffer.
+   *
+   * The characters of the string are taken from the font table in one pass and
+   * packed into buf with the spacing set by setTextSpacing() and the kerning pairs
+   * set by setKerning() between them. The buffer is in the same format as for blit()
+   * and setCanvas(): one byte for each column, the first byte is the leftmost column
+   * of the text. The text can therefore be rendered once and then shown with blit()
+   * or scrolled with setViewport(). Characters not in the font are skipped.
+   *
+   * If the font has characters above 255 (a version 2 font with 16 bit character
+   * codes) the string is decoded as UTF-8, otherwise each byte is a character code.
+   * Bytes that are not valid UTF-8 are used as character codes and characters above
+   * U+FFFF are replaced by U+FFFD.
+   *
+   * If buf is nullptr the text is only measured, reading just the width of each
+   * character. Otherwise buf is cleared and the columns past the end of the buffer
+   * are not stored, so measuring first allows a buffer of the right size to be used.
+   *
+   * NOTE: This function is only available if the library defined value
+   * USE_LOCAL_FONT is set to 1.
+   *
+   * \param s     the nul terminated text string.
+   * \param buf   address of the user buffer for the columns, nullptr to only measure the text.
+   * \param size  the size of the user buffer in uint8_t units.
+   * \param font  font table to use, nullptr for the current font set by setFont().
+   * \return width (in columns) of the rendered text, which may be larger than size.
+   */
+  uint16_t renderText(const char *s, uint8_t *buf, uint16_t size, fontType_t *font = nullptr) { return(renderString(s, nullptr, buf, size, font)); };
+
+  /**
+   * Render a string of 16 bit character codes into a column buffer.
+   *
+   * As for renderText() with a char string, but each element of the string is a
+   * character code.
+   *
+   * NOTE: This function is only available if the library defined value
+   * USE_LOCAL_FONT is set to 1.
+   *
+   * \param s     the string of character codes, terminated by 0.
+   * \param buf   address of the user buffer for the columns, nullptr to only measure the text.
+   * \param size  the size of the user buffer in uint8_t units.
+   * \param font  font table to use, nullptr for the current font set by setFont().
+   * \return width (in columns) of the rendered text, which may be larger than size.
+   */
+  uint16_t renderText(const uint16_t *s, uint8_t *buf, uint16_t size, fontType_t *font = nullptr) { return(renderString(nullptr, s, buf, size, font)); };
+
+  /**
+   * Get the width of a text string.
+   *
+   * The width is the same as the text rendered by renderText(), including the
+   * character spacing and kerning, but only the width of each character is read
+   * from the font table and the display is not changed. With USE_FONT_INDEX
+   * enabled each character is found in constant time, so this is cheap enough
+   * to use for every frame of a dynamic layout (eg, to center or right justify text).
+   *
+   * NOTE: This function is only available if the library defined value
+   * USE_LOCAL_FONT is set to 1.
+   *
+   * \param s     the nul terminated text string, UTF-8 for fonts with 16 bit character codes.
+   * \param font  font table to use, nullptr for the current font set by setFont().
+   * \return width (in columns) of the text.
+   */
+  uint16_t getTextWidth(const char *s, fontType_t *font = nullptr) { return(renderString(s, nullptr, nullptr, 0, font)); };
+
+  /**
+   * Get the width of a string of 16 bit character codes.
+   *
+   * As for getTextWidth() with a char string, but each element of the string is a
+   * character code.
+   *
+   * NOTE: This function is only available if the library defined value
+   * USE_LOCAL_FONT is set to 1.
+   *
+   * \param s     the string of character codes, terminated by 0.
+   * \param font  font table to use, nullptr for the current font set by setFont().
+   * \return width (in columns) of the text.
+   */
+  uint16_t getTextWidth(const uint16_t *s, fontType_t *font = nullptr) { return(renderString(nullptr, s, nullptr, 0, font)); };
+
+  /**
+   * Get the width of a character.
+   *
+   * Only the width of the character is read from the current font table.
+   *
+   * NOTE: This function is only available if the library defined value
+   * USE_LOCAL_FONT is set to 1.
+   *
+   * \param c  the character code.
+   * \return width (in columns) of the character, 0 if it is not in the font.
+   */
+  uint8_t getCharWidth(uint16_t c);
+
+  /**
+   * Get the character cache statistics.
+   *
+   * Returns the number of character lookups found in the character cache and
+   * read from the font table, to help choose GLYPH_CACHE_SIZE. The counts are
+   * only changed if GLYPH_CACHE_SIZE is not 0.
+   *
+   * NOTE: This function is only available if the library defined value
+   * USE_LOCAL_FONT is set to 1.
+   *
+   * \return reference to the character cache statistics structure.
+   */
+  const glyphCacheStats_t& getGlyphCacheStats(void) { return(_glyphStats); };
+
+  /**
+   * Reset the character cache statistics to zero.
+   *
+   * NOTE: This function is only available if the library defined value
+   * USE_LOCAL_FONT is set to 1.
+   */
+  void resetGlyphCacheStats(void) { _glyphStats.hits = _glyphStats.misses = 0; };
+
+  /**
+   * Set the spacing between characters for renderText().
+   *
+   * NOTE: This function is only available if the library defined value
+   * USE_LOCAL_FONT is set to 1.
+   *
+   * \param spacing number of blank columns between characters, default 1.
+   */
+  void setTextSpacing(uint8_t spacing) { _charSpacing = spacing; };
+
+  /**
+   * Set the kerning pairs for renderText().
+   *
+   * The kerning pairs change the spacing between specific pairs of characters
+   * (eg, to move a 'T' and a following 'o' closer together). When the spacing is
+   * negative the columns of the characters overlap and are combined. The table is
+   * searched for every pair of characters, so it should be kept short. The table
+   * is not copied and must remain valid while it is in use.
+   *
+   * NOTE: This function is only available if the library defined value
+   * USE_LOCAL_FONT is set to 1.
+   *
+   * \param pairs  array of kerning pairs in RAM, nullptr for none.
+   * \param count  number of elements in pairs.
+   */
+  void setKerning(const kernPair_t *pairs, uint8_t count) { _kernPairs = pairs; _kernCount = (pairs == nullptr) ? 0 : count; };
+
   /**
    * Set the current font table.
    *
@@ -963,6 +2308,11 @@ public:
    * the nominated font (default or user defined). To specify a user defined
    * character set, pass the PROGMEM address of the font table. Passing a nullptr
    * resets the font table to the library default table.
+   *
+   * The font properties (see FONT_CACHE_SIZE) and characters (see
+   * GLYPH_CACHE_SIZE) are cached with the address of the font table. If the
+   * data at the same address is changed, or the address is reused for a
+   * different font, clearFontCache() must be called before the font is used.
    * 
    * NOTE: This function is only available if the library defined value
    * USE_LOCAL_FONT is set to 1.
@@ -972,6 +2322,43 @@ public:
    */
   bool setFont(fontType_t *f);
 
+  /**
+   * Set the current font to be read from a font source.
+   *
+   * The font data is read through the font source object, so the font table
+   * may be stored anywhere (eg, in a file on an SD card). All characters
+   * retrieved or used after this call will use this font. The font is read
+   * once to work out its properties and an index of character offsets is
+   * kept in RAM (see FONT_SOURCE_STEP). The properties are cached with the
+   * address of the source object (see FONT_CACHE_SIZE), so clearFontCache()
+   * must be called if an object is reused for a different font or the font
+   * data it reads is changed. The source object is not copied and
+   * must remain valid while it is in use. Passing a nullptr resets the font
+   * table to the library default table.
+   *
+   * NOTE: This function is only available if the library defined value
+   * USE_LOCAL_FONT is set to 1.
+   *
+   * \param src pointer to the font source object or nullptr.
+   * \return false if the read-ahead buffer could not be allocated, true otherwise.
+   */
+  bool setFontSource(MD_MAX72XX_FontSource *src);
+
+  /**
+   * Clear the font caches.
+   *
+   * The font properties and characters are cached with the address of the
+   * font table or font source (see FONT_CACHE_SIZE and GLYPH_CACHE_SIZE), so
+   * a change to the font data at the same address is not seen by the library.
+   * This method discards all the cached fonts and characters, frees the RAM
+   * used by their indexes and analyses the current font again. The character
+   * cache statistics are not changed.
+   *
+   * NOTE: This function is only available if the library defined value
+   * USE_LOCAL_FONT is set to 1.
+   */
+  void clearFontCache(void);
+
   /**
   * Get the maximum width character for the font.
   *
@@ -999,6 +2386,20 @@ public:
   */
   uint8_t getFontHeight(void) { return(_fontInfo.height); };
 
+  /**
+  * Get the properties of the current font.
+  *
+  * Returns the properties of the currently selected font table. These are
+  * worked out when the font is selected and are returned without any further
+  * access to the font table.
+  *
+  * NOTE: This function is only available if the library defined value
+  * USE_LOCAL_FONT is set to 1.
+  *
+  * \return reference to the font properties structure.
+  */
+  const fontInfo_t& getFontInfo(void) { return(_fontInfo); };
+
   /**
    * Get the pointer to current font table.
    *
@@ -1008,35 +2409,117 @@ public:
    * NOTE: This function is only available if the library defined value
    * USE_LOCAL_FONT is set to 1.
    *
-   * \return pointer to the start of the font table in PROGMEM.
+   * \return pointer to the start of the font table in PROGMEM, nullptr if the font is set with setFontSource().
    */
   fontType_t *getFont(void) { return(_fontData); };
+
+  /**
+   * Get the pointer to current font source.
+   *
+   * NOTE: This function is only available if the library defined value
+   * USE_LOCAL_FONT is set to 1.
+   *
+   * \return pointer to the font source set by setFontSource(), nullptr if the font is set with setFont().
+   */
+  MD_MAX72XX_FontSource *getFontSource(void) { return(_fontSource); };
 #endif // USE_LOCAL_FONT
   /** @} */
 
 private:
+  // The compile time module type class uses the device buffers directly
+  template <moduleType_t HW> friend class MD_MAX72XX_T;
+
   typedef struct
   {
   uint8_t dig[ROW_SIZE];  // data for each digit of the MAX72xx (DIG0-DIG7)
   uint8_t changed;        // one bit for each digit changed ('dirty bit')
+#if USE_CANONICAL_BUFFER
+  uint8_t pending;        // digits still to be sent when module digits are columns
+#endif
   } deviceInfo_t;
 
+  // Pixel data collected for one device at a time by the drawing methods
+  typedef struct
+  {
+    int16_t buf;            // device being collected, -1 if none
+    uint8_t data[COL_SIZE]; // column data in pixel coordinates
+    uint8_t mask[COL_SIZE]; // bits of data[] to be used
+    rasterOp_t rop;         // how the data is combined with the display
+    int16_t firstChanged;   // lowest device changed, -1 if none
+    int16_t lastChanged;    // highest device changed, -1 if none
+  } drawBatch_t;
+
+  // Virtual canvas shown in a window of the display
+  typedef struct
+  {
+    const uint8_t *data;    // column data, nullptr if no canvas set
+    uint16_t width;         // number of columns in data
+    bool     progmem;       // data is in PROGMEM
+    int16_t  offset;        // canvas column shown at colEnd
+    uint16_t colStart;      // lowest display column of the window
+    uint16_t colEnd;        // highest display column of the window
+  } canvasInfo_t;
+
+  // Separately selected chain of devices
+  typedef struct
+  {
+    int8_t  csPin;          // CS/LD output for the chain
+    uint8_t lastDev;        // last device in the chain
+  } chainInfo_t;
+
+  // Device mounted as a tile in a 2D display
+  typedef struct
+  {
+    uint8_t dev;            // device for the tile
+    uint8_t map;            // rotation (bits 6-7) and the XOR of the device row (bits 3-5) and column (bits 0-2)
+  } tileInfo_t;
+
   // LED module wiring parameters defined by hardware type
   moduleType_t _mod;  // The module type from the available list
+  bool _modFixed;     // module type is fixed at compile time by MD_MAX72XX_T
   bool _hwDigRows;    // MAX72xx digits are mapped to rows in on the matrix
   bool _hwRevCols;    // Normal orientation is col 0 on the right. Set to true if reversed
   bool _hwRevRows;    // Normal orientation is row 0 at the top. Set to true if reversed
+#if USE_CANONICAL_BUFFER
+  bool _modDigRows;   // module hardware values of the flags above, applied when data is sent
+  bool _modRevCols;
+  bool _modRevRows;
+#endif
 
   int8_t _dataPin;     // DATA is shifted out of this pin ...
   int8_t _clkPin;      // ... signaled by a CLOCK on this pin ...
   int8_t _csPin;       // ... and LOADed when the chip select pin is driven HIGH to LOW
   bool    _hardwareSPI; // true if SPI interface is the hardware interface
+#if !HOST_BUILD_ACTIVE
   SPIClass& _spiRef;    // reference to the SPI object to use for hardware comms 
+#endif
+  MD_MAX72XX_Transport* _transport; // alternative communications object, nullptr if not used
+  chainInfo_t* _chain;  // devices split into chains, nullptr for one chain
+  uint8_t _chainCount;  // number of chains in _chain
 
   // Device buffer data
   uint8_t _maxDevices;  // maximum number of devices in use
   deviceInfo_t* _matrix;// the current status of the LED matrix (buffers)
+  tileInfo_t* _tile;    // 2D display tiles in row order from the top left, nullptr if not set
+  uint8_t   _tileCols;  // number of tiles in each row of the 2D display
+  uint8_t   _tileRows;  // number of rows of tiles in the 2D display
   uint8_t*  _spiData;   // data buffer for writing to SPI interface
+  uint8_t*  _spiNext;   // second data buffer for asynchronous updates, allocated when first used
+
+  // Asynchronous update data
+  bool    _asyncActive;   // an asynchronous update is in progress
+  bool    _asyncStaged;   // _spiNext holds data ready to send
+  uint8_t _asyncRows;     // digit rows still to be sent, one bit per row
+  void    (*_cbUpdate)(void); // user callback for asynchronous update complete
+
+  // Time sliced frame update data
+  deviceInfo_t* _frame;   // copy of the display buffers for the frame being sent, allocated when first used
+  uint8_t  _frameRows;    // digit rows of the frame still to be sent, one bit per row
+  uint16_t _sliceBytes;   // maximum bytes sent by serviceFrame(), 0 for no limit
+  uint16_t _sliceMicros;  // maximum time used by serviceFrame(), 0 for no limit
+
+  // Virtual canvas data
+  canvasInfo_t _canvas;   // canvas and window set by setCanvas() and setCanvasWindow()
 
   // User callback function for shifting operations
   uint8_t (*_cbShiftDataIn)(uint8_t dev, transformType_t t);
@@ -1045,6 +2528,8 @@ private:
   // Control data for the library
   bool    _updateEnabled; // update the display when this is true, suspend otherwise
   bool    _wrapAround;    // when shifting, wrap left to right and vice versa (circular buffer)
+  bool    _burst;         // when updating all devices, send all the data in one SPI transaction
+  updateStats_t _updateStats; // communications used by the last update
 
   // SPI interface data
 #if MBED_SPI_ACTIVE
@@ -1053,42 +2538,123 @@ private:
 #endif
 
 #if USE_LOCAL_FONT
-  // Font properties info structure
-   typedef struct
-   {
-     uint8_t version;     // (v1) font definition version number (for compliance)
-     uint8_t height;      // (v1) font height in pixels
-     uint8_t widthMax;    // (v1) font maximum width in pixels (widest character)
-     uint16_t firstASCII; // (v1,2) the first character code in the font table
-     uint16_t lastASCII;  // (v1,2) the last character code in the font table
-     uint16_t dataOffset; // (v1) offset from the start of table to first character definition
-   } fontInfo_t;
+  // Font properties cache entry
+  typedef struct
+  {
+    const void  *font;      // font table or font source for this entry, nullptr if unused
+    fontInfo_t  info;       // properties of the font table
+#if USE_FONT_INDEX
+    uint16_t    *index;     // character offset index, owned by the cache entry
+#endif
+    uint32_t    *steps;     // font source offset index, owned by the cache entry
+    uint32_t    step;       // characters between entries in steps
+  } fontCache_t;
+
+  // Character data found by getGlyph()
+  typedef struct
+  {
+    uint8_t       width;    // number of columns
+    const uint8_t *data;    // column data in RAM, nullptr if in the font table
+    uint32_t      offset;   // offset of the column data in the font table
+  } glyph_t;
+
+#if GLYPH_CACHE_SIZE
+  // Character cache entry
+  typedef struct
+  {
+    const void  *font;      // font table or font source for this entry, nullptr if unused
+    uint16_t    code;       // character code
+    uint16_t    used;       // _glyphClock when last used
+    uint8_t     width;      // number of columns
+    uint8_t     data[GLYPH_CACHE_WIDTH]; // column data
+  } glyphCache_t;
+
+  glyphCache_t _glyphCache[GLYPH_CACHE_SIZE]; // recently used characters
+  uint16_t    _glyphClock;                    // incremented on every use of a cache entry
+#endif
+  glyphCacheStats_t _glyphStats;              // character cache hits and misses
 
   // Font related data
   fontType_t  *_fontData;   // pointer to the current font data being used
+  MD_MAX72XX_FontSource *_fontSource; // current font source, nullptr if the font is in _fontData
   fontInfo_t  _fontInfo;    // properties of the current font table
+#if USE_FONT_INDEX
+  uint16_t    *_fontIndex;  // offset of each character in the font table, nullptr if not built
+#endif
+  uint32_t    *_fontSteps;  // offset of every _fontStep'th character of a font source, nullptr if not built
+  uint32_t    _fontStep;    // characters between entries in _fontSteps
+  uint8_t     *_fontAhead;  // read-ahead buffer for font sources, allocated when first used
+  uint32_t    _aheadStart;  // font offset of the first byte in _fontAhead
+  uint16_t    _aheadLen;    // number of valid bytes in _fontAhead
+  fontCache_t _fontCache[FONT_CACHE_SIZE]; // properties of recently used font tables
+  uint8_t     _fontCacheNext;              // next cache entry to be replaced
+  uint8_t     _charSpacing;                // blank columns between characters in renderText()
+  const kernPair_t *_kernPairs;            // kerning pairs for renderText(), nullptr if none
+  uint8_t     _kernCount;                  // number of pairs in _kernPairs
 
   void    setFontInfoDefault(void);      // set the default parameters for the font info file
-  void    loadFontInfo(void);            // load the font info block from the font data
-  uint8_t getFontWidth(void);            // get the maximum font width by inspecting the font table
+  void    loadFontInfo(void);            // load the font info block from the font data or cache
+  void    analyseFont(void);             // work out font properties by inspecting the font table
   int32_t getFontCharOffset(uint16_t c); // find the character in the font data. If not there, return -1
+  int16_t kernAdjust(uint16_t c1, uint16_t c2); // spacing adjustment for the pair of characters
+  uint16_t nextChar(const char *&s);      // next character code from the string, UTF-8 for 16 bit fonts
+  const void *fontKey(void) { return(_fontSource != nullptr ? (const void *)_fontSource : (const void *)_fontData); }; // identifies the current font in the caches
+  uint8_t fontByte(uint32_t offset) { return(_fontSource == nullptr ? pgm_read_byte(_fontData + offset) : sourceByte(offset)); };
+  uint16_t fontWord(uint32_t offset) { return((fontByte(offset) << 8) | fontByte(offset + 1)); }; // big endian 16 bit value
+  uint8_t sourceByte(uint32_t offset);   // read a byte from the font source through the read-ahead buffer
+  bool    getGlyph(uint16_t c, glyph_t &g); // find the character in the cache or the font data, false if not there
+  int16_t getGlyphWidth(uint16_t c);     // width of the character without filling the cache, -1 if not there
+  uint8_t glyphByte(const glyph_t &g, uint8_t i) { return(g.data != nullptr ? g.data[i] : fontByte(g.offset + i)); };
+  uint16_t renderString(const char *s, const uint16_t *s16, uint8_t *buf, uint16_t size, fontType_t *font); // render or measure s or s16
 #endif
 
   // Private functions
   void spiSend(void);         // do the actual physical communications task
+  void spiBegin(void);        // start a communications transaction
+  void spiFrame(void);        // send the SPI buffer to the devices in one device selection per chain
+  void spiChainFrame(uint8_t chain, uint16_t offset, uint16_t size); // send part of the SPI buffer to one chain
+  uint16_t rowBytes(uint8_t r); // bytes sent for the changes in digit r of all devices
+  void spiEnd(void);          // end a communications transaction
+  void spiWait(void);         // wait until the SPI buffer can be changed
+  void spiUpdateStart(void);  // finish any update in progress and reset the statistics
+  bool spiBuildRow(uint8_t *data, uint8_t r); // put changed data for digit r of all devices in the data buffer
+  inline uint8_t flushRows(uint8_t buf);  // digits of the device to be sent, one bit per digit
+  inline uint8_t flushDigit(uint8_t buf, uint8_t d); // data to send for digit d, marked as sent
+  void asyncStage(void);      // prepare the next asynchronous update row in the second buffer
+  uint32_t sliceTime(void);   // current time in microseconds for time sliced updates
   inline void spiClearBuffer(void);  // clear the SPI send buffer
   void controlHardware(uint8_t dev, controlRequest_t mode, int value);  // set hardware control commands
   void controlLibrary(controlRequest_t mode, int value);  // set internal control commands
 
   void flushBuffer(uint8_t buf);  // determine what needs to be sent for one device and transmit
   void flushBufferAll(void);      // determine what needs to be sent for all devices and transmit
+  void flushBufferRows(uint32_t maxBytes);  // send changed digit rows for all devices using up to maxBytes
+  uint8_t changedRows(void);      // digit rows changed in any device, one bit per digit
 
   uint8_t bitReverse(uint8_t b);  // reverse the order of bits in the byte
+  void transpose8(uint8_t *d);    // transpose the 8x8 bit matrix in d[8]
+  void reverseDigits(uint8_t *d); // reverse the order of the bytes in d[8]
+  void loadDigits(uint8_t buf, uint8_t *d);         // copy the device digits to d[8] in pixel coordinates
+  void storeDigits(uint8_t buf, const uint8_t *d);  // copy d[8] in pixel coordinates to the device digits
+  bool blitDevice(uint8_t buf, uint8_t *data, uint8_t *mask, rasterOp_t rop); // combine column data with the device digits
+  void drawStart(drawBatch_t &db, rasterOp_t rop);  // start collecting pixel data for the display
+  void drawColumn(drawBatch_t &db, int16_t c, uint8_t data, uint8_t mask); // add data for the mask bits of column c
+  void drawCommit(drawBatch_t &db);                 // combine the collected data with the device buffer
+  void drawEnd(drawBatch_t &db);                    // commit and send the changes to the devices
+  uint8_t rowMask(int8_t r1, int8_t r2);            // bits for rows r1..r2 that are on the display
+  int16_t clipColumn(int32_t c);                    // column c limited to one column either side of the display
+  void circle(int8_t r, int16_t c, uint8_t radius, bool state, bool fill); // outline or filled circle
+  void loadTile(uint8_t tile, uint8_t *t);        // copy the tile to t[8] in 2D display coordinates
+  void storeTile(uint8_t tile, const uint8_t *t); // copy t[8] in 2D display coordinates to the tile
+  void shiftTileRow(uint8_t ty, transformType_t ttype);  // TSL/TSR across a row of tiles
+  void shiftTileCol(uint8_t tx, transformType_t ttype);  // TSU/TSD across a column of tiles
   bool transformBuffer(uint8_t buf, transformType_t ttype); // internal transform function
+  void shiftDigRows(uint8_t startDev, uint8_t endDev, transformType_t ttype); // TSL/TSR across devices for _hwDigRows hardware
 
   bool copyRow(uint8_t buf, uint8_t rSrc, uint8_t rDest);   // copy a row from Src to Dest
   bool copyColumn(uint8_t buf, uint8_t cSrc, uint8_t cDest);// copy a row from Src to Dest
 
+  void initObject(moduleType_t mod);            // common constructor initialization
   void setModuleParameters(moduleType_t mod);   // setup parameters based on module type
 
   // _hwDigRev switched function for internal use
@@ -1100,3 +2666,266 @@ private:
   bool setR(uint8_t buf, uint8_t r, uint8_t value);
 
 };
+
+/**
+ * Core object for the MD_MAX72XX library with the module type fixed at compile time.
+ *
+ * The module type is a template parameter, so the hardware orientation is known
+ * when the application is compiled. The pixel, row and column methods defined in
+ * this class have the coordinate mapping resolved by the compiler instead of
+ * testing the module type flags on each call, which makes them smaller and faster.
+ * All other methods are inherited unchanged from MD_MAX72XX.
+ *
+ * The methods in this class are not virtual. The speed improvement only applies
+ * when they are called through an MD_MAX72XX_T object, reference or pointer. Use the
+ * MD_MAX72XX class if the module type needs to be selected at run time (eg, as in
+ * the MD_MAX72xx_Dynamic_HW example).
+ *
+ * Example:
+ * \code
+ * MD_MAX72XX_T<MD_MAX72XX::FC16_HW> mx(CS_PIN, MAX_DEVICES);
+ * \endcode
+ */
+template <MD_MAX72XX::moduleType_t HW>
+class MD_MAX72XX_T : public MD_MAX72XX
+{
+public:
+#if !HOST_BUILD_ACTIVE
+  /**
+   * Class Constructor - arbitrary digital interface.
+   *
+   * See the equivalent MD_MAX72XX constructor.
+   *
+   * \param dataPin   output on the Arduino where data gets shifted out.
+   * \param clkPin    output for the clock signal.
+   * \param csPin     output for selecting the device.
+   * \param numDevices  number of devices connected. Default is 1 if not supplied.
+   */
+  MD_MAX72XX_T(int8_t dataPin, int8_t clkPin, int8_t csPin, uint8_t numDevices = 1) :
+    MD_MAX72XX(HW, dataPin, clkPin, csPin, numDevices) { _modFixed = true; };
+
+  /**
+   * Class Constructor - SPI hardware interface.
+   *
+   * See the equivalent MD_MAX72XX constructor.
+   *
+   * \param csPin     output for selecting the device.
+   * \param numDevices  number of devices connected. Default is 1 if not supplied.
+   */
+  MD_MAX72XX_T(int8_t csPin, uint8_t numDevices = 1) :
+    MD_MAX72XX(HW, csPin, numDevices) { _modFixed = true; };
+
+  /**
+   * Class Constructor - specify SPI hardware interface.
+   *
+   * See the equivalent MD_MAX72XX constructor.
+   *
+   * \param spi       reference to the SPI object to use for comms to the device
+   * \param csPin     output for selecting the device.
+   * \param numDevices  number of devices connected. Default is 1 if not supplied.
+   */
+  MD_MAX72XX_T(SPIClass &spi, int8_t csPin, uint8_t numDevices = 1) :
+    MD_MAX72XX(HW, spi, csPin, numDevices) { _modFixed = true; };
+#endif
+
+  /**
+   * Class Constructor - alternative communications interface.
+   *
+   * See the equivalent MD_MAX72XX constructor.
+   *
+   * \param transport reference to the communications object.
+   * \param numDevices  number of devices connected. Default is 1 if not supplied.
+   */
+  MD_MAX72XX_T(MD_MAX72XX_Transport &transport, uint8_t numDevices = 1) :
+    MD_MAX72XX(HW, transport, numDevices) { _modFixed = true; };
+
+  /**
+   * The module type is fixed by the template parameter and cannot be changed.
+   * Calls through a reference to MD_MAX72XX are ignored.
+   */
+  void setModuleType(moduleType_t mod) = delete;
+
+  // Make the overloads that are not redefined here visible
+  using MD_MAX72XX::getColumn;
+  using MD_MAX72XX::setColumn;
+  using MD_MAX72XX::getRow;
+  using MD_MAX72XX::setRow;
+
+  /**
+   * Get the state of one LED. See MD_MAX72XX::getPoint().
+   *
+   * \param r  row coordinate for the point [0..ROW_SIZE-1].
+   * \param c  column coordinate for the point [0..getColumnCount()-1].
+   * \return true if LED is on, false if off or parameter errors.
+   */
+  bool getPoint(uint8_t r, uint16_t c)
+  {
+    uint8_t buf = c/COL_SIZE;
+
+    c %= COL_SIZE;
+    if ((buf >= _maxDevices) || (r >= ROW_SIZE))
+      return(false);
+
+    if (digRows())
+      return(bitRead(_matrix[buf].dig[hwRow(r)], hwCol(c)) == 1);
+    else
+      return(bitRead(_matrix[buf].dig[hwRow(c)], hwCol(r)) == 1);
+  };
+
+  /**
+   * Set the state of one LED. See MD_MAX72XX::setPoint().
+   *
+   * \param r  row coordinate for the point [0..ROW_SIZE-1].
+   * \param c  column coordinate for the point [0..getColumnCount()-1].
+   * \param state true - switch on; false - switch off.
+   * \return false if parameter errors, true otherwise.
+   */
+  bool setPoint(uint8_t r, uint16_t c, bool state)
+  {
+    uint8_t buf = c/COL_SIZE;
+
+    c %= COL_SIZE;
+    if ((buf >= _maxDevices) || (r >= ROW_SIZE))
+      return(false);
+
+    const uint8_t d = digRows() ? hwRow(r) : hwRow(c);
+    const uint8_t mask = 1 << (digRows() ? hwCol(c) : hwCol(r));
+
+    if (state)
+      _matrix[buf].dig[d] |= mask;
+    else
+      _matrix[buf].dig[d] &= ~mask;
+    _matrix[buf].changed |= (1 << d);
+
+    if (_updateEnabled) flushBuffer(buf);
+
+    return(true);
+  };
+
+  /**
+   * Get the LEDs in a column of one device. See MD_MAX72XX::getColumn().
+   *
+   * \param buf  address of the display [0..getDeviceCount()-1].
+   * \param c    column which is to be set [0..COL_SIZE-1].
+   * \return uint8_t value with each bit set to 1 if the corresponding LED is lit. 0 is returned for parameter error.
+   */
+  uint8_t getColumn(uint8_t buf, uint8_t c)
+  {
+    if ((buf >= _maxDevices) || (c >= COL_SIZE)) return(0);
+    return(digRows() ? getAcross(buf, c) : getDigit(buf, c));
+  };
+
+  /**
+   * Get the LEDs in a column of the display. See MD_MAX72XX::getColumn().
+   *
+   * \param c    column which is to be set [0..getColumnCount()-1].
+   * \return uint8_t value with each bit set to 1 if the corresponding LED is lit. 0 is returned for parameter error.
+   */
+  uint8_t getColumn(uint16_t c) { return(getColumn((uint8_t)(c / COL_SIZE), (uint8_t)(c % COL_SIZE))); };
+
+  /**
+   * Set the LEDs in a column of one device. See MD_MAX72XX::setColumn().
+   *
+   * \param buf    address of the display [0..getDeviceCount()-1].
+   * \param c      column which is to be set [0..COL_SIZE-1].
+   * \param value  each bit set to 1 will light up the corresponding LED.
+   * \return false if parameter errors, true otherwise.
+   */
+  bool setColumn(uint8_t buf, uint8_t c, uint8_t value)
+  {
+    if ((buf >= _maxDevices) || (c >= COL_SIZE)) return(false);
+    if (digRows()) setAcross(buf, c, value); else setDigit(buf, c, value);
+    if (_updateEnabled) flushBuffer(buf);
+    return(true);
+  };
+
+  /**
+   * Set the LEDs in a column of the display. See MD_MAX72XX::setColumn().
+   *
+   * \param c      column which is to be set [0..getColumnCount()-1].
+   * \param value  each bit set to 1 will light up the corresponding LED.
+   * \return false if parameter errors, true otherwise.
+   */
+  bool setColumn(uint16_t c, uint8_t value) { return(setColumn((uint8_t)(c / COL_SIZE), (uint8_t)(c % COL_SIZE), value)); };
+
+  /**
+   * Get the LEDs in a row of one device. See MD_MAX72XX::getRow().
+   *
+   * \param buf  address of the display [0..getDeviceCount()-1].
+   * \param r    row which is to be set [0..ROW_SIZE-1].
+   * \return uint8_t value with each bit set to 1 if the corresponding LED is lit. 0 is returned for parameter error.
+   */
+  uint8_t getRow(uint8_t buf, uint8_t r)
+  {
+    if ((buf >= _maxDevices) || (r >= ROW_SIZE)) return(0);
+    return(digRows() ? getDigit(buf, r) : getAcross(buf, r));
+  };
+
+  /**
+   * Set the LEDs in a row of one device. See MD_MAX72XX::setRow().
+   *
+   * \param buf    address of the display [0..getDeviceCount()-1].
+   * \param r      row which is to be set [0..ROW_SIZE-1].
+   * \param value  each bit set to 1 within this byte will light up the corresponding LED.
+   * \return false if parameter errors, true otherwise.
+   */
+  bool setRow(uint8_t buf, uint8_t r, uint8_t value)
+  {
+    if ((buf >= _maxDevices) || (r >= ROW_SIZE)) return(false);
+    if (digRows()) setDigit(buf, r, value); else setAcross(buf, r, value);
+    if (_updateEnabled) flushBuffer(buf);
+    return(true);
+  };
+
+private:
+  // Module type flags; DR - Digits as rows (4); CR - Columns Reversed (2); RR - Rows Reversed (1)
+  static constexpr uint8_t hwFlags(void)
+  {
+    return(USE_CANONICAL_BUFFER ? 4 :   // buffer layout does not depend on the module
+      HW == GENERIC_HW ? 2 : HW == FC16_HW ? 4 : HW == PAROLA_HW ? 6 : HW == ICSTATION_HW ? 7 : HW - DR0CR0RR0_HW);
+  }
+  static constexpr bool digRows(void) { return((hwFlags() & 4) != 0); }
+  static constexpr bool revCols(void) { return((hwFlags() & 2) != 0); }
+  static constexpr bool revRows(void) { return((hwFlags() & 1) != 0); }
+  static constexpr uint8_t allChanged = 0xff;  // changed mask for all the digits of a buffer
+
+  // Pixel to hardware coordinate mapping, as HW_ROW() and HW_COL()
+  static constexpr uint8_t hwRow(uint8_t r) { return(revRows() ? ROW_SIZE - 1 - r : r); }
+  static constexpr uint8_t hwCol(uint8_t c) { return(revCols() ? COL_SIZE - 1 - c : c); }
+
+  // Get/set the line of pixels held in one digit (as getR()/setR())
+  uint8_t getDigit(uint8_t buf, uint8_t i)
+  {
+    uint8_t value = _matrix[buf].dig[hwRow(i)];
+
+    return(revCols() ? bitReverse(value) : value);
+  }
+
+  void setDigit(uint8_t buf, uint8_t i, uint8_t value)
+  {
+    _matrix[buf].dig[hwRow(i)] = revCols() ? bitReverse(value) : value;
+    _matrix[buf].changed |= (1 << hwRow(i));
+  }
+
+  // Get/set the line of pixels held in the same bit of every digit (as getC()/setC())
+  uint8_t getAcross(uint8_t buf, uint8_t i)
+  {
+    uint8_t value = 0;
+
+    for (uint8_t k=0; k<ROW_SIZE; k++)
+      value |= ((_matrix[buf].dig[hwRow(k)] >> hwCol(i)) & 1) << k;
+
+    return(value);
+  }
+
+  void setAcross(uint8_t buf, uint8_t i, uint8_t value)
+  {
+    for (uint8_t k=0; k<ROW_SIZE; k++)
+    {
+      uint8_t d = _matrix[buf].dig[hwRow(k)] & ~(1 << hwCol(i));
+
+      _matrix[buf].dig[hwRow(k)] = d | (((value >> k) & 1) << hwCol(i));
+    }
+    _matrix[buf].changed = allChanged;
+  }
+};
@@ -31,6 +31,8 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
  * \brief Implements buffer related methods
  */
 
+// Every _hwDigRows path has a DR0 path that must give the same pixel result
+
 bool MD_MAX72XX::clear(uint8_t buf)
 {
   if (buf > LAST_BUFFER)
@@ -44,15 +46,91 @@ bool MD_MAX72XX::clear(uint8_t buf)
   return(true);
 }
 
+#if USE_BITREVERSE_TABLE
+// Bit reversed value for each byte value
+static const uint8_t PROGMEM bitReverseTable[256] =
+{
+  0x00, 0x80, 0x40, 0xc0, 0x20, 0xa0, 0x60, 0xe0, 0x10, 0x90, 0x50, 0xd0, 0x30, 0xb0, 0x70, 0xf0,
+  0x08, 0x88, 0x48, 0xc8, 0x28, 0xa8, 0x68, 0xe8, 0x18, 0x98, 0x58, 0xd8, 0x38, 0xb8, 0x78, 0xf8,
+  0x04, 0x84, 0x44, 0xc4, 0x24, 0xa4, 0x64, 0xe4, 0x14, 0x94, 0x54, 0xd4, 0x34, 0xb4, 0x74, 0xf4,
+  0x0c, 0x8c, 0x4c, 0xcc, 0x2c, 0xac, 0x6c, 0xec, 0x1c, 0x9c, 0x5c, 0xdc, 0x3c, 0xbc, 0x7c, 0xfc,
+  0x02, 0x82, 0x42, 0xc2, 0x22, 0xa2, 0x62, 0xe2, 0x12, 0x92, 0x52, 0xd2, 0x32, 0xb2, 0x72, 0xf2,
+  0x0a, 0x8a, 0x4a, 0xca, 0x2a, 0xaa, 0x6a, 0xea, 0x1a, 0x9a, 0x5a, 0xda, 0x3a, 0xba, 0x7a, 0xfa,
+  0x06, 0x86, 0x46, 0xc6, 0x26, 0xa6, 0x66, 0xe6, 0x16, 0x96, 0x56, 0xd6, 0x36, 0xb6, 0x76, 0xf6,
+  0x0e, 0x8e, 0x4e, 0xce, 0x2e, 0xae, 0x6e, 0xee, 0x1e, 0x9e, 0x5e, 0xde, 0x3e, 0xbe, 0x7e, 0xfe,
+  0x01, 0x81, 0x41, 0xc1, 0x21, 0xa1, 0x61, 0xe1, 0x11, 0x91, 0x51, 0xd1, 0x31, 0xb1, 0x71, 0xf1,
+  0x09, 0x89, 0x49, 0xc9, 0x29, 0xa9, 0x69, 0xe9, 0x19, 0x99, 0x59, 0xd9, 0x39, 0xb9, 0x79, 0xf9,
+  0x05, 0x85, 0x45, 0xc5, 0x25, 0xa5, 0x65, 0xe5, 0x15, 0x95, 0x55, 0xd5, 0x35, 0xb5, 0x75, 0xf5,
+  0x0d, 0x8d, 0x4d, 0xcd, 0x2d, 0xad, 0x6d, 0xed, 0x1d, 0x9d, 0x5d, 0xdd, 0x3d, 0xbd, 0x7d, 0xfd,
+  0x03, 0x83, 0x43, 0xc3, 0x23, 0xa3, 0x63, 0xe3, 0x13, 0x93, 0x53, 0xd3, 0x33, 0xb3, 0x73, 0xf3,
+  0x0b, 0x8b, 0x4b, 0xcb, 0x2b, 0xab, 0x6b, 0xeb, 0x1b, 0x9b, 0x5b, 0xdb, 0x3b, 0xbb, 0x7b, 0xfb,
+  0x07, 0x87, 0x47, 0xc7, 0x27, 0xa7, 0x67, 0xe7, 0x17, 0x97, 0x57, 0xd7, 0x37, 0xb7, 0x77, 0xf7,
+  0x0f, 0x8f, 0x4f, 0xcf, 0x2f, 0xaf, 0x6f, 0xef, 0x1f, 0x9f, 0x5f, 0xdf, 0x3f, 0xbf, 0x7f, 0xff
+};
+#endif
+
 uint8_t MD_MAX72XX::bitReverse(uint8_t b)
 // Reverse the order of bits within a byte.
 // Returns the reversed byte value.
 {
+#if USE_BITREVERSE_TABLE
+  return(pgm_read_byte(&bitReverseTable[b]));
+#else
   b = ((b & 0xf0) >>  4) | ((b & 0x0f) << 4);
   b = ((b & 0xcc) >>  2) | ((b & 0x33) << 2);
   b = ((b & 0xaa) >>  1) | ((b & 0x55) << 1);
 
   return(b);
+#endif
+}
+
+void MD_MAX72XX::transpose8(uint8_t *d)
+// Transpose the 8x8 bit matrix in d[] in place, so that bit j of byte i
+// becomes bit i of byte j. This is the delta swap method (Hacker's Delight
+// transpose8) split into two 32 bit words so it is also efficient on 8 bit
+// processors: swap the bits in 1x1 blocks, then the 2x2 blocks within each
+// word, then the 4x4 blocks between the words.
+{
+  uint32_t x = (uint32_t)d[0] | ((uint32_t)d[1] << 8) | ((uint32_t)d[2] << 16) | ((uint32_t)d[3] << 24);
+  uint32_t y = (uint32_t)d[4] | ((uint32_t)d[5] << 8) | ((uint32_t)d[6] << 16) | ((uint32_t)d[7] << 24);
+  uint32_t t;
+
+  t = (x ^ (x >> 7)) & 0x00aa00aa;  x ^= t ^ (t << 7);
+  t = (y ^ (y >> 7)) & 0x00aa00aa;  y ^= t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000cccc; x ^= t ^ (t << 14);
+  t = (y ^ (y >> 14)) & 0x0000cccc; y ^= t ^ (t << 14);
+  t = ((x >> 4) ^ y) & 0x0f0f0f0f;  y ^= t; x ^= (t << 4);
+
+  d[0] = x; d[1] = x >> 8; d[2] = x >> 16; d[3] = x >> 24;
+  d[4] = y; d[5] = y >> 8; d[6] = y >> 16; d[7] = y >> 24;
+}
+
+void MD_MAX72XX::loadDigits(uint8_t buf, uint8_t *d)
+// Copy the digits of the device buffer to d[] in pixel coordinates.
+// These are the rows for _hwDigRows hardware and the columns otherwise.
+{
+  for (uint8_t i=0; i<ROW_SIZE; i++)
+    d[i] = _hwRevCols ? bitReverse(_matrix[buf].dig[HW_ROW(i)]) : _matrix[buf].dig[HW_ROW(i)];
+}
+
+void MD_MAX72XX::reverseDigits(uint8_t *d)
+// Reverse the order of the 8 bytes in d[].
+{
+  for (uint8_t i=0; i<ROW_SIZE/2; i++)
+  {
+    uint8_t t = d[i];
+
+    d[i] = d[ROW_SIZE-1-i];
+    d[ROW_SIZE-1-i] = t;
+  }
+}
+
+void MD_MAX72XX::storeDigits(uint8_t buf, const uint8_t *d)
+// Copy d[] in pixel coordinates to the digits of the device buffer.
+{
+  for (uint8_t i=0; i<ROW_SIZE; i++)
+    _matrix[buf].dig[HW_ROW(i)] = _hwRevCols ? bitReverse(d[i]) : d[i];
+  _matrix[buf].changed = ALL_CHANGED;
 }
 
 bool MD_MAX72XX::copyColumn(uint8_t buf, uint8_t cSrc, uint8_t cDest)
@@ -71,8 +149,6 @@ bool MD_MAX72XX::copyC(uint8_t buf, uint8_t cSrc, uint8_t cDest)
 // Src and Dest are in pixel coordinates.
 // if we are just copying rows there is no need to repackage any data
 {
-  uint8_t maskSrc = 1 << HW_COL(cSrc);  // which column/row of bits is the column data
-
   if (_hwDigRows) { PRINT("\ncopyCol: (", buf); }
   else { PRINT("\ncopyRow: (", buf); }
   PRINT(", ", cSrc);
@@ -82,12 +158,14 @@ bool MD_MAX72XX::copyC(uint8_t buf, uint8_t cSrc, uint8_t cDest)
   if ((buf > LAST_BUFFER) || (cSrc >= COL_SIZE) || (cDest >= COL_SIZE))
     return(false);
 
+  const uint8_t bitSrc = HW_COL(cSrc);
+  const uint8_t bitDest = HW_COL(cDest);
+
   for (uint8_t i=0; i<ROW_SIZE; i++)
   {
-      if (_matrix[buf].dig[i] & maskSrc)
-        bitSet(_matrix[buf].dig[i], HW_COL(cDest));
-    else
-        bitClear(_matrix[buf].dig[i], HW_COL(cDest));
+    uint8_t d = _matrix[buf].dig[i];
+
+    _matrix[buf].dig[i] = (d & ~(1 << bitDest)) | (((d >> bitSrc) & 1) << bitDest);
   }
 
   _matrix[buf].changed = ALL_CHANGED;
@@ -133,7 +211,6 @@ uint8_t MD_MAX72XX::getRow(uint8_t buf, uint8_t r)
 uint8_t MD_MAX72XX::getC(uint8_t buf, uint8_t c)
 // c is in pixel coordinates and the return value must be in pixel coordinate order
 {
-  uint8_t mask = 1 << HW_COL(c);  // which column/row of bits is the column data
   uint8_t value = 0;        // assembles data to be returned to caller
 
   if (_hwDigRows) { PRINT("\ngetCol: (", buf); }
@@ -144,15 +221,12 @@ uint8_t MD_MAX72XX::getC(uint8_t buf, uint8_t c)
   if ((buf > LAST_BUFFER) || (c >= COL_SIZE))
     return(0);
 
-  PRINTX("mask 0x", mask);
+  const uint8_t bit = HW_COL(c);  // which column/row of bits is the column data
 
   // for each digit data, pull out the column/row bit and place
   // it in value. The loop creates the data in pixel coordinate order as it goes.
   for (uint8_t i=0; i<ROW_SIZE; i++)
-  {
-      if (_matrix[buf].dig[HW_ROW(i)] & mask)
-        bitSet(value, i);
-  }
+    value |= ((_matrix[buf].dig[HW_ROW(i)] >> bit) & 1) << i;
 
   PRINTX(" value 0x", value);
 
@@ -201,12 +275,14 @@ bool MD_MAX72XX::setC(uint8_t buf, uint8_t c, uint8_t value)
   if ((buf > LAST_BUFFER) || (c >= COL_SIZE))
     return(false);
 
+  const uint8_t bit = HW_COL(c);
+
+  // mask off next column/row value passed in and set it in the dig buffer
   for (uint8_t i=0; i<ROW_SIZE; i++)
   {
-      if (value & (1 << i))   // mask off next column/row value passed in and set it in the dig buffer
-        bitSet(_matrix[buf].dig[HW_ROW(i)], HW_COL(c));
-      else
-        bitClear(_matrix[buf].dig[HW_ROW(i)], HW_COL(c));
+    uint8_t d = _matrix[buf].dig[HW_ROW(i)] & ~(1 << bit);
+
+    _matrix[buf].dig[HW_ROW(i)] = d | (((value >> i) & 1) << bit);
   }
   _matrix[buf].changed = ALL_CHANGED;
 
@@ -247,6 +323,45 @@ bool MD_MAX72XX::transform(uint8_t buf, transformType_t ttype)
   return(true);
 }
 
+void MD_MAX72XX::shiftDigRows(uint8_t startDev, uint8_t endDev, transformType_t ttype)
+// Shift one column left (TSL) or right (TSR) across the devices for hardware with
+// digits as rows. Each digit row across the devices is one string of bits, so the bit
+// shifted out of a device is carried into the next device in the same pass.
+// Four digit rows are processed together in a 32 bit word, with the carries for each
+// row kept in the matching byte of the carry word. The column that is shifted into
+// startDev (TSL) or endDev (TSR) is cleared and set by the caller.
+{
+  const bool shiftUp = ((ttype == TSL) != _hwRevCols); // bits move towards the MSB
+  uint32_t carry[ROW_SIZE/4] = { 0 };
+
+  for (uint16_t n = 0; n <= endDev - startDev; n++)
+  {
+    uint8_t buf = (ttype == TSL) ? startDev + n : endDev - n;
+
+    for (uint8_t i = 0; i < ROW_SIZE/4; i++)
+    {
+      uint32_t w;
+
+      memcpy(&w, &_matrix[buf].dig[i*4], sizeof(w));
+      if (shiftUp)
+      {
+        uint32_t c = (w >> 7) & 0x01010101;
+        w = ((w << 1) & 0xfefefefe) | carry[i];
+        carry[i] = c;
+      }
+      else
+      {
+        uint32_t c = (w << 7) & 0x80808080;
+        w = ((w >> 1) & 0x7f7f7f7f) | carry[i];
+        carry[i] = c;
+      }
+      memcpy(&_matrix[buf].dig[i*4], &w, sizeof(w));
+    }
+
+    _matrix[buf].changed = ALL_CHANGED;
+  }
+}
+
 bool MD_MAX72XX::transformBuffer(uint8_t buf, transformType_t ttype)
 {
   uint8_t t[ROW_SIZE];
@@ -267,8 +382,12 @@ bool MD_MAX72XX::transformBuffer(uint8_t buf, transformType_t ttype)
       }
       else
       {
-        for (uint8_t i=ROW_SIZE; i>0; --i)
-          _matrix[buf].dig[i] = _matrix[buf].dig[i-1];
+        // columns are whole digits, so move the digit bytes along
+        if (_hwRevRows)
+          memmove(&_matrix[buf].dig[0], &_matrix[buf].dig[1], ROW_SIZE-1);
+        else
+          memmove(&_matrix[buf].dig[1], &_matrix[buf].dig[0], ROW_SIZE-1);
+        _matrix[buf].dig[HW_ROW(0)] = 0;
       }
       break;
 
@@ -286,49 +405,73 @@ bool MD_MAX72XX::transformBuffer(uint8_t buf, transformType_t ttype)
       }
       else
       {
-        for (uint8_t i=0; i<ROW_SIZE-1; i++)
-          _matrix[buf].dig[i] = _matrix[buf].dig[i+1];
+        // columns are whole digits, so move the digit bytes along
+        if (_hwRevRows)
+          memmove(&_matrix[buf].dig[1], &_matrix[buf].dig[0], ROW_SIZE-1);
+        else
+          memmove(&_matrix[buf].dig[0], &_matrix[buf].dig[1], ROW_SIZE-1);
+        _matrix[buf].dig[HW_ROW(COL_SIZE-1)] = 0;
       }
     break;
 
   //--------------
     case TSU: // Transform Shift Up one pixel element
-    if (_wrapAround)  // save the first row or a zero row
-      t[0] = getRow(buf, 0);
-    else
-      t[0] = 0;
-
     if (_hwDigRows)
     {
-      for (uint8_t i=0; i<ROW_SIZE-1; i++)
-        copyRow(buf, i+1, i);
+      // rows are whole digits, so move the digit bytes along
+      t[0] = _wrapAround ? _matrix[buf].dig[HW_ROW(0)] : 0;
+      if (_hwRevRows)
+        memmove(&_matrix[buf].dig[1], &_matrix[buf].dig[0], ROW_SIZE-1);
+      else
+        memmove(&_matrix[buf].dig[0], &_matrix[buf].dig[1], ROW_SIZE-1);
+      _matrix[buf].dig[HW_ROW(ROW_SIZE-1)] = t[0];
     }
     else
     {
-      for (int8_t i=ROW_SIZE-1; i>=0; i--)
-        _matrix[buf].dig[i] <<= 1;
+      if (_wrapAround)  // save the first row or a zero row
+        t[0] = getRow(buf, 0);
+      else
+        t[0] = 0;
+
+      for (uint8_t i=0; i<ROW_SIZE; i++)
+      {
+        if (_hwRevCols)
+          _matrix[buf].dig[i] <<= 1;
+        else
+          _matrix[buf].dig[i] >>= 1;
+      }
+      setRow(buf, ROW_SIZE-1, t[0]);
     }
-    setRow(buf, ROW_SIZE-1, t[0]);
     break;
 
   //--------------
     case TSD: // Transform Shift Down one pixel element
-    if (_wrapAround)  // save the last row or a zero row
-      t[0] = getRow(buf, ROW_SIZE-1);
-    else
-      t[0] = 0;
-
     if (_hwDigRows)
     {
-      for (uint8_t i=ROW_SIZE; i>0; --i)
-        copyRow(buf, i-1, i);
+      // rows are whole digits, so move the digit bytes along
+      t[0] = _wrapAround ? _matrix[buf].dig[HW_ROW(ROW_SIZE-1)] : 0;
+      if (_hwRevRows)
+        memmove(&_matrix[buf].dig[0], &_matrix[buf].dig[1], ROW_SIZE-1);
+      else
+        memmove(&_matrix[buf].dig[1], &_matrix[buf].dig[0], ROW_SIZE-1);
+      _matrix[buf].dig[HW_ROW(0)] = t[0];
     }
     else
     {
+      if (_wrapAround)  // save the last row or a zero row
+        t[0] = getRow(buf, ROW_SIZE-1);
+      else
+        t[0] = 0;
+
       for (uint8_t i=0; i<ROW_SIZE; i++)
-        _matrix[buf].dig[i] >>= 1;
+      {
+        if (_hwRevCols)
+          _matrix[buf].dig[i] >>= 1;
+        else
+          _matrix[buf].dig[i] <<= 1;
+      }
+      setRow(buf, 0, t[0]);
     }
-    setRow(buf, 0, t[0]);
     break;
 
   //--------------
@@ -369,11 +512,14 @@ bool MD_MAX72XX::transformBuffer(uint8_t buf, transformType_t ttype)
 
   //--------------
   case TRC: // Transform Rotate Clockwise
-    for (uint8_t i=0; i<ROW_SIZE; i++)
-      t[i] = getColumn(buf, COL_SIZE-1-i);
-
-    for (uint8_t i=0; i<ROW_SIZE; i++)
-      setRow(buf, i, t[i]);
+    // new row i is old column COL_SIZE-1-i, so the rotated digits are the
+    // transposed digits in reverse order (_hwDigRows) or the transpose of
+    // the digits in reverse order (columns).
+    loadDigits(buf, t);
+    if (!_hwDigRows) reverseDigits(t);
+    transpose8(t);
+    if (_hwDigRows) reverseDigits(t);
+    storeDigits(buf, t);
     break;
 
   //--------------
@@ -41,6 +41,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
 void MD_MAX72XX::setFontInfoDefault(void)
 // Set the defaults for the info block compatible with version 0 of the file
 {
+  memset(&_fontInfo, 0, sizeof(_fontInfo));
   _fontInfo.version = 0;
   _fontInfo.height = 8;
   _fontInfo.widthMax = 0;
@@ -50,83 +51,203 @@ void MD_MAX72XX::setFontInfoDefault(void)
 }
 
 void MD_MAX72XX::loadFontInfo(void)
+// Use the cached information if we have seen this font before, otherwise
+// read the header and analyse the font table into the oldest cache entry.
 {
   uint8_t c;
   uint16_t offset = 0;
-  
+  fontCache_t *fc;
+
+  for (uint8_t i = 0; i < FONT_CACHE_SIZE; i++)
+  {
+    if (_fontCache[i].font == fontKey())
+    {
+      PRINT("\nFont info cached ", i);
+      _fontInfo = _fontCache[i].info;
+#if USE_FONT_INDEX
+      _fontIndex = _fontCache[i].index;
+#endif
+      _fontSteps = _fontCache[i].steps;
+      _fontStep = _fontCache[i].step;
+      return;
+    }
+  }
+
+  fc = &_fontCache[_fontCacheNext];
+  _fontCacheNext = (_fontCacheNext + 1) % FONT_CACHE_SIZE;
+#if USE_FONT_INDEX
+  free(fc->index);
+  fc->index = _fontIndex = nullptr;
+#endif
+  free(fc->steps);
+  fc->steps = _fontSteps = nullptr;
+
   setFontInfoDefault();
 
-  if (_fontData != nullptr)
+  if ((_fontData != nullptr) || (_fontSource != nullptr))
   {
     PRINTS("\nLoading font info");
     // Read the first character. If this is not the file type indicator
     // then we have a version 0 file and the defaults are ok, otherwise 
     // read the font info from the data table. 
-    c = pgm_read_byte(_fontData + offset++);
+    c = fontByte(offset++);
     if (c == FONT_FILE_INDICATOR)
     {
-      c = pgm_read_byte(_fontData + offset++);  // read the version number
+      c = fontByte(offset++);  // read the version number
       switch (c)
       {
+        case 3:
+          _fontInfo.height = fontByte(offset++);
+          _fontInfo.rangeCount = fontWord(offset);
+          offset = FONT_RANGE_OFFSET + (_fontInfo.rangeCount * FONT_RANGE_SIZE);
+          _fontInfo.dirOffset = offset;
+          if (_fontInfo.rangeCount != 0)
+          {
+            uint16_t last = offset - FONT_RANGE_SIZE;   // last range table entry
+
+            _fontInfo.firstASCII = fontWord(FONT_RANGE_OFFSET);
+            _fontInfo.lastASCII = fontWord(last + 2);
+            // the directory has one entry for every character in the ranges
+            offset += 2 * (fontWord(last + 4) + (_fontInfo.lastASCII - fontWord(last)) + 1);
+          }
+          else
+            _fontInfo.firstASCII = _fontInfo.lastASCII = 0;
+          break;
+
         case 2:
-          _fontInfo.firstASCII = (pgm_read_byte(_fontData + offset++) << 8);
-          _fontInfo.firstASCII += pgm_read_byte(_fontData + offset++);
-          _fontInfo.lastASCII = (pgm_read_byte(_fontData + offset++) << 8);
-          _fontInfo.lastASCII += pgm_read_byte(_fontData + offset++);
-          _fontInfo.height = pgm_read_byte(_fontData + offset++);
+          _fontInfo.firstASCII = (fontByte(offset++) << 8);
+          _fontInfo.firstASCII += fontByte(offset++);
+          _fontInfo.lastASCII = (fontByte(offset++) << 8);
+          _fontInfo.lastASCII += fontByte(offset++);
+          _fontInfo.height = fontByte(offset++);
           break;
 
         case 1:
-          _fontInfo.firstASCII = pgm_read_byte(_fontData + offset++);
-          _fontInfo.lastASCII  = pgm_read_byte(_fontData + offset++);
-          _fontInfo.height     = pgm_read_byte(_fontData + offset++);
+          _fontInfo.firstASCII = fontByte(offset++);
+          _fontInfo.lastASCII  = fontByte(offset++);
+          _fontInfo.height     = fontByte(offset++);
           break;
         
         case 0:
-        default:
           // nothing to do, use the library defaults
           break;
+
+        default:
+          _fontInfo.flags |= FONT_UNKNOWN_VER;
+          break;
       }
+      _fontInfo.version = c;
       _fontInfo.dataOffset = offset;
     }
     PRINT(" F: ", _fontInfo.firstASCII);
     PRINT(" L: ", _fontInfo.lastASCII);
     PRINT(" H: ", _fontInfo.height);
 
-    // these always set
-    _fontInfo.widthMax = getFontWidth();
+    analyseFont();
   }
+
+  fc->font = fontKey();
+  fc->info = _fontInfo;
+#if USE_FONT_INDEX
+  fc->index = _fontIndex;
+#endif
+  fc->steps = _fontSteps;
+  fc->step = _fontStep;
 }
 
-uint8_t MD_MAX72XX::getFontWidth(void)
+void MD_MAX72XX::analyseFont(void)
+// Walk the font table once to work out the font properties. If enabled, 
+// the offset for each character is saved in the index at the same time so 
+// that getFontCharOffset() does not need to search. The index is not built 
+// if there is not enough RAM or the offsets do not fit in 16 bits, and the 
+// font table is searched as before. For a font source, the offset of every 
+// _fontStep'th character is saved instead if the full index is not built, so
+// a search only needs to start from the nearest of these. The step is
+// FONT_SOURCE_STEP unless that needs more than FONT_SOURCE_INDEX_MAX entries.
+// Version 3 fonts already have a character directory and need no index, and
+// their character data is walked in order without reading the directory.
 {
-  uint8_t   max = 0;
   uint8_t   charWidth;
   uint32_t  offset = _fontInfo.dataOffset;
+  uint32_t  count;              // number of characters in the font table
+  uint32_t  end = offset;       // end of the character data
+  uint32_t  next = 0;           // next character saved in _fontSteps
+
+  PRINTS("\nAnalysing font");
+
+  _fontInfo.widthMax = 0;
+  _fontInfo.widthMin = UINT8_MAX;
+  _fontInfo.charCount = 0;
+  _fontInfo.flags &= ~(FONT_FIXED_WIDTH | FONT_EMPTY_CHARS | FONT_INDEXED);
 
-  PRINTS("\nFinding max font width");
-  if (_fontData != nullptr)
+  if (_fontInfo.version == 3)
+    count = (_fontInfo.dataOffset - _fontInfo.dirOffset) / 2;
+  else
   {
-    for (uint16_t i = _fontInfo.firstASCII; i <= _fontInfo.lastASCII; i++)
+    count = (_fontInfo.lastASCII < _fontInfo.firstASCII) ? 0 : (uint32_t)_fontInfo.lastASCII - _fontInfo.firstASCII + 1;
+#if USE_FONT_INDEX
+    _fontIndex = (uint16_t *)malloc(sizeof(uint16_t) * count);
+#endif
+    if (_fontSource != nullptr)
     {
-      charWidth = pgm_read_byte(_fontData + offset);
-      /*
-      PRINT("\nASCII '", i);
-      PRINT("' offset ", offset);
-      PRINT("' width ", charWidth);
-      */
-      if (charWidth > max)
+      _fontStep = FONT_SOURCE_STEP;
+      if ((count + FONT_SOURCE_STEP - 1) / FONT_SOURCE_STEP > FONT_SOURCE_INDEX_MAX)
+        _fontStep = (count + FONT_SOURCE_INDEX_MAX - 1) / FONT_SOURCE_INDEX_MAX;
+      _fontSteps = (uint32_t *)malloc(sizeof(uint32_t) * ((count + _fontStep - 1) / _fontStep));
+    }
+  }
+
+  for (uint32_t i = 0; i < count; i++)
+  {
+#if USE_FONT_INDEX
+    if (_fontIndex != nullptr)
+    {
+      if (offset > UINT16_MAX)
       {
-        max = charWidth;
-        PRINT(":", max);
+        PRINTS(" - no index");
+        free(_fontIndex);
+        _fontIndex = nullptr;
       }
-      offset += charWidth;  // skip character data
-      offset++; // skip to size byte
+      else
+        _fontIndex[i] = offset;
+    }
+#endif
+    if ((_fontSteps != nullptr) && (i == next))
+    {
+      _fontSteps[i / _fontStep] = offset;
+      next += _fontStep;
+    }
+
+    charWidth = fontByte(offset);
+    if (charWidth == 0)
+      _fontInfo.flags |= FONT_EMPTY_CHARS;
+    else
+    {
+      _fontInfo.charCount++;
+      if (charWidth > _fontInfo.widthMax) _fontInfo.widthMax = charWidth;
+      if (charWidth < _fontInfo.widthMin) _fontInfo.widthMin = charWidth;
     }
+    offset += charWidth;  // skip character data
+    offset++; // skip to size byte
+    if (offset > end) end = offset;
+  }
+
+  if (_fontInfo.charCount == 0)
+    _fontInfo.widthMin = 0;
+  else if (_fontInfo.widthMin == _fontInfo.widthMax)
+    _fontInfo.flags |= FONT_FIXED_WIDTH;
+#if USE_FONT_INDEX
+  if (_fontIndex != nullptr)
+  {
+    _fontInfo.flags |= FONT_INDEXED;
+    free(_fontSteps);   // not needed with the full index
+    _fontSteps = nullptr;
   }
-  PRINT(" max ", max);
+#endif
+  _fontInfo.dataSize = end;
 
-  return(max);
+  PRINT(" max ", _fontInfo.widthMax);
+  PRINT(" size ", _fontInfo.dataSize);
 }
 
 int32_t MD_MAX72XX::getFontCharOffset(uint16_t c)
@@ -137,12 +258,55 @@ int32_t MD_MAX72XX::getFontCharOffset(uint16_t c)
 
   if (c < _fontInfo.firstASCII || c > _fontInfo.lastASCII)
     offset = -1;
+  else if (_fontInfo.version == 3)
+  {
+    // binary search of the range table, then the offset is in the directory
+    uint16_t lo = 0, hi = _fontInfo.rangeCount;
+
+    offset = -1;
+    while (lo < hi)
+    {
+      uint16_t mid = lo + ((hi - lo) / 2);
+      uint16_t r = FONT_RANGE_OFFSET + (mid * FONT_RANGE_SIZE);
+      uint16_t first = fontWord(r);
+
+      if (c < first)
+        hi = mid;
+      else if (c > fontWord(r + 2))
+        lo = mid + 1;
+      else
+      {
+        uint16_t n = fontWord(r + 4) + (c - first);  // directory entry
+
+        offset = _fontInfo.dataOffset + fontWord(_fontInfo.dirOffset + (2 * n));
+        break;
+      }
+    }
+    PRINT(" directory offset ", offset);
+  }
+#if USE_FONT_INDEX
+  else if (_fontIndex != nullptr)
+  {
+    offset = _fontIndex[c - _fontInfo.firstASCII];
+    PRINT(" indexed offset ", offset);
+  }
+#endif
   else
   {
-    for (uint16_t i=_fontInfo.firstASCII; i<c; i++)
+    uint16_t i = _fontInfo.firstASCII;
+
+    if (_fontSteps != nullptr)  // start from the nearest saved offset
+    {
+      uint16_t n = (c - _fontInfo.firstASCII) / _fontStep;
+
+      offset = _fontSteps[n];
+      i += n * _fontStep;
+    }
+
+    for ( ; i<c; i++)
     {
       PRINTS(".");
-      offset += pgm_read_byte(_fontData+offset);
+      offset += fontByte(offset);
       offset++; // skip size byte we used above
     }
 
@@ -151,10 +315,84 @@ int32_t MD_MAX72XX::getFontCharOffset(uint16_t c)
   return(offset);
 }
 
+uint8_t MD_MAX72XX::sourceByte(uint32_t offset)
+// Refill the read-ahead buffer from the font source when the offset is not
+// in it. Characters and the width bytes skipped by a search are read in order,
+// so most bytes come from the buffer.
+{
+  if (offset - _aheadStart >= _aheadLen)  // also true if offset < _aheadStart
+  {
+    _aheadStart = offset;
+    _aheadLen = _fontSource->read(offset, _fontAhead, FONT_READ_AHEAD);
+    if (_aheadLen == 0)
+      return(0);
+  }
+
+  return(_fontAhead[offset - _aheadStart]);
+}
+
+bool MD_MAX72XX::getGlyph(uint16_t c, glyph_t &g)
+// Find the character in the cache, or in the font table and then copy it into
+// the least recently used cache entry if it is not too wide.
+{
+  int32_t offset;
+
+#if GLYPH_CACHE_SIZE
+  glyphCache_t *e = &_glyphCache[0];  // entry to replace
+
+  if (++_glyphClock == 0)   // start the ages again when the clock wraps
+  {
+    for (uint8_t i = 0; i < GLYPH_CACHE_SIZE; i++)
+      _glyphCache[i].used = 0;
+    _glyphClock = 1;
+  }
+
+  for (uint8_t i = 0; i < GLYPH_CACHE_SIZE; i++)
+  {
+    glyphCache_t *p = &_glyphCache[i];
+
+    if ((p->font == fontKey()) && (p->code == c))
+    {
+      _glyphStats.hits++;
+      p->used = _glyphClock;
+      g.width = p->width;
+      g.data = p->data;
+      return(true);
+    }
+    if (p->used < e->used) e = p;
+  }
+  _glyphStats.misses++;
+#endif
+
+  offset = getFontCharOffset(c);
+  if (offset == -1)
+    return(false);
+
+  g.width = fontByte(offset);
+  g.data = nullptr;
+  g.offset = offset + 1;
+
+#if GLYPH_CACHE_SIZE
+  if (g.width <= GLYPH_CACHE_WIDTH)
+  {
+    e->font = fontKey();
+    e->code = c;
+    e->used = _glyphClock;
+    e->width = g.width;
+    for (uint8_t i = 0; i < g.width; i++)
+      e->data[i] = fontByte(g.offset + i);
+    g.data = e->data;
+  }
+#endif
+
+  return(true);
+}
+
 bool MD_MAX72XX::setFont(fontType_t *f)
 {
-  if (f != _fontData) // we actually have a change to process
+  if ((f != _fontData) || (_fontSource != nullptr)) // we actually have a change to process
   {
+    _fontSource = nullptr;
     _fontData = (f == nullptr ? _sysfont : f);
     loadFontInfo();
   }
@@ -162,6 +400,50 @@ bool MD_MAX72XX::setFont(fontType_t *f)
   return(true);
 }
 
+bool MD_MAX72XX::setFontSource(MD_MAX72XX_FontSource *src)
+{
+  if (src == nullptr)
+    return(setFont(nullptr));
+
+  if (_fontAhead == nullptr)
+  {
+    _fontAhead = (uint8_t *)malloc(FONT_READ_AHEAD);
+    if (_fontAhead == nullptr)
+      return(false);
+  }
+
+  if (src != _fontSource) // we actually have a change to process
+  {
+    _fontSource = src;
+    _fontData = nullptr;
+    _aheadLen = 0;  // buffer is for the previous source
+    loadFontInfo();
+  }
+
+  return(true);
+}
+
+void MD_MAX72XX::clearFontCache(void)
+// Forget everything cached for all fonts and analyse the current font again.
+{
+  for (uint8_t i = 0; i < FONT_CACHE_SIZE; i++)
+  {
+#if USE_FONT_INDEX
+    free(_fontCache[i].index);
+#endif
+    free(_fontCache[i].steps);
+  }
+  memset(_fontCache, 0, sizeof(_fontCache));
+  _fontCacheNext = 0;
+#if GLYPH_CACHE_SIZE
+  memset(_glyphCache, 0, sizeof(_glyphCache));
+  _glyphClock = 0;
+#endif
+  _aheadLen = 0;
+
+  loadFontInfo();
+}
+
 uint8_t MD_MAX72XX::getChar(uint16_t c, uint8_t size, uint8_t *buf)
 {
   PRINT("\ngetChar: '", (char)c);
@@ -171,20 +453,19 @@ uint8_t MD_MAX72XX::getChar(uint16_t c, uint8_t size, uint8_t *buf)
   if (buf == nullptr)
     return(0);
 
-  int32_t offset = getFontCharOffset(c);
-  if (offset == -1)
+  glyph_t g;
+
+  if (!getGlyph(c, g))
   {
     memset(buf, 0, size);
     size = 0;
   }
   else
   {
-    size = min(size, pgm_read_byte(_fontData+offset));
-
-    offset++; // skip the size byte
+    if (g.width < size) size = g.width;
 
     for (uint8_t i=0; i<size; i++)
-      *buf++ = pgm_read_byte(_fontData+offset+i);
+      *buf++ = glyphByte(g, i);
   }
   
   return(size);
@@ -195,28 +476,171 @@ uint8_t MD_MAX72XX::setChar(uint16_t col, uint16_t c)
   PRINT("\nsetChar: '", c);
   PRINT("' column ", col);
   boolean b = _updateEnabled;
-  uint8_t size;
+  glyph_t g;
+
+  if (!getGlyph(c, g))
+    return(0);
+
+  _updateEnabled = false;
+  for (uint8_t i=0; i<g.width; i++)
+    setColumn(col--, glyphByte(g, i));
+  _updateEnabled = b;
+
+  if (_updateEnabled) flushBufferAll();
+
+  return(g.width);
+}
+
+int16_t MD_MAX72XX::kernAdjust(uint16_t c1, uint16_t c2)
+{
+  for (uint8_t i = 0; i < _kernCount; i++)
+  {
+    if ((_kernPairs[i].first == c1) && (_kernPairs[i].second == c2))
+      return(_kernPairs[i].adjust);
+  }
+
+  return(0);
+}
+
+uint16_t MD_MAX72XX::nextChar(const char *&s)
+// Return the next character and move s past it, 0 at the end of the string.
+// Only fonts with 16 bit character codes are decoded as UTF-8, so the 8 bit
+// character codes in existing strings are unchanged. Bytes that do not start
+// a valid UTF-8 sequence are returned as they are.
+{
+  uint8_t  b = (uint8_t)*s;
+  uint8_t  n;     // number of continuation bytes
+  uint32_t c;
+
+  if (b == '\0')
+    return(0);
+
+  s++;
+  if ((b < 0x80) || (_fontInfo.lastASCII <= UINT8_MAX))
+    return(b);
+
+  if ((b & 0xe0) == 0xc0)      { n = 1; c = b & 0x1f; }
+  else if ((b & 0xf0) == 0xe0) { n = 2; c = b & 0x0f; }
+  else if ((b & 0xf8) == 0xf0) { n = 3; c = b & 0x07; }
+  else
+    return(b);  // not a UTF-8 lead byte
+
+  for (uint8_t i = 0; i < n; i++)
+  {
+    if ((s[i] & 0xc0) != 0x80)
+      return(b);  // sequence cut short, use the byte as it is
+    c = (c << 6) | (s[i] & 0x3f);
+  }
+
+  // overlong forms, surrogates and values past U+10FFFF are not valid UTF-8
+  if ((c < ((n == 1) ? 0x80UL : (n == 2) ? 0x800UL : 0x10000UL)) ||
+      ((c >= 0xd800) && (c <= 0xdfff)) || (c > 0x10ffff))
+    return(b);
+  s += n;
+
+  return((c > UINT16_MAX) ? 0xfffd : c);
+}
+
+int16_t MD_MAX72XX::getGlyphWidth(uint16_t c)
+// Only the width byte is read and the character cache is not changed, so
+// measuring text does not replace the characters being displayed.
+{
+  int32_t offset;
+
+#if GLYPH_CACHE_SIZE
+  for (uint8_t i = 0; i < GLYPH_CACHE_SIZE; i++)
+  {
+    if ((_glyphCache[i].font == fontKey()) && (_glyphCache[i].code == c))
+      return(_glyphCache[i].width);
+  }
+#endif
 
-  int32_t offset = getFontCharOffset(c);
+  offset = getFontCharOffset(c);
   if (offset == -1)
+    return(-1);
+
+  return(fontByte(offset));
+}
+
+uint8_t MD_MAX72XX::getCharWidth(uint16_t c)
+{
+  int16_t w = getGlyphWidth(c);
+
+  return(w < 0 ? 0 : w);
+}
+
+uint16_t MD_MAX72XX::renderString(const char *s, const uint16_t *s16, uint8_t *buf, uint16_t size, fontType_t *font)
+// Each character starts after the previous one plus the spacing and kerning.
+// Characters are ORed into the buffer so that negative spacing overlaps them.
+{
+  fontType_t *saved = _fontData;
+  MD_MAX72XX_FontSource *savedSource = _fontSource;
+  int32_t  pos = 0;       // column where the current character starts
+  uint16_t width = 0;     // columns used by the text so far
+  uint8_t  lastWidth = 0; // width of the previous character
+  uint16_t last = 0;      // previous character
+  bool     first = true;
+
+  PRINT("\nrenderString: bufsize ", size);
+
+  if ((s == nullptr) && (s16 == nullptr))
     return(0);
 
-  size = pgm_read_byte(_fontData+offset);
+  if (font != nullptr) setFont(font);
+  if (buf != nullptr) memset(buf, 0, size);
 
-  offset++; // skip the size byte
+  while (true)
+  {
+    uint16_t c = (s16 != nullptr) ? *s16++ : nextChar(s);
+    glyph_t g;
 
-  _updateEnabled = false;
-  for (int8_t i=0; i<size; i++)
+    if (c == 0)
+      break;
+
+    if (buf == nullptr)   // measuring only needs the width
+    {
+      int16_t w = getGlyphWidth(c);
+
+      if (w < 0)
+        continue;
+      g.width = w;
+    }
+    else if (!getGlyph(c, g))
+      continue;
+
+    if (!first)
+    {
+      int16_t gap = _charSpacing + kernAdjust(last, c);
+
+      if (gap < -lastWidth) gap = -lastWidth;   // never before the previous character
+      pos += lastWidth + gap;
+    }
+
+    if (buf != nullptr)
+    {
+      for (uint8_t i = 0; (i < g.width) && (pos + i < size); i++)
+        buf[pos + i] |= glyphByte(g, i);
+    }
+
+    if (pos + g.width > width) width = pos + g.width;
+    last = c;
+    lastWidth = g.width;
+    first = false;
+  }
+
+  if (font != nullptr)
   {
-    uint8_t colData = pgm_read_byte(_fontData+offset+i);
-    setColumn(col--, colData);
+    if (savedSource != nullptr)
+      setFontSource(savedSource);
+    else
+      setFont(saved);
   }
-  _updateEnabled = b;
 
-  if (_updateEnabled) flushBufferAll();
+  PRINT(" width ", width);
 
-  return(size);
+  return(width);
 }
+
 // Standard font - variable spacing
 MD_MAX72XX::fontType_t PROGMEM _sysfont[] =
 {
@@ -0,0 +1,276 @@
+/*
+MD_MAX72xx - Library for using a MAX7219/7221 LED matrix controller
+
+See header file for comments
+
+This file contains methods that draw graphics shapes on the matrix
+as a pixel field.
+
+Copyright (C) 2012-14 Marco Colli. All rights reserved.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+#include "MD_MAX72xx.h"
+#include "MD_MAX72xx_lib.h"
+
+/**
+ * \file
+ * \brief Implements graphics drawing methods
+ */
+
+void MD_MAX72XX::drawLine(int8_t r1, int16_t c1, int8_t r2, int16_t c2, bool state)
+{
+  drawBatch_t db;
+  int32_t dc, dr, err;    // 32 bits as 2 * err can exceed 16 bits for long lines
+  int8_t sr;
+
+  PRINT("\nline: (", r1);
+  PRINT(", ", c1);
+  PRINT(") to (", r2);
+  PRINT(", ", c2);
+  PRINTS(")");
+
+  // always draw in increasing column order so devices are only visited once
+  if (c1 > c2)
+  {
+    int16_t tc = c1; c1 = c2; c2 = tc;
+    int8_t  tr = r1; r1 = r2; r2 = tr;
+  }
+
+  // Bresenham's line algorithm
+  dc = c2 - c1;
+  dr = -abs(r2 - r1);
+  sr = (r1 < r2) ? 1 : -1;
+  err = dc + dr;
+
+  drawStart(db, ROP_COPY);
+  while (true)
+  {
+    uint8_t m = rowMask(r1, r1);
+
+    drawColumn(db, c1, state ? m : 0, m);
+    if ((c1 == c2) && (r1 == r2))
+      break;
+
+    int32_t e2 = 2 * err;
+
+    if (e2 >= dr) { err += dr; c1++; }
+    if (e2 <= dc) { err += dc; r1 += sr; }
+  }
+  drawEnd(db);
+}
+
+void MD_MAX72XX::drawRect(int8_t r1, int16_t c1, int8_t r2, int16_t c2, bool state)
+{
+  drawBatch_t db;
+  uint8_t edge, side;
+
+  PRINT("\nrect: (", r1);
+  PRINT(", ", c1);
+  PRINT(") to (", r2);
+  PRINT(", ", c2);
+  PRINTS(")");
+
+  if (c1 > c2) { int16_t t = c1; c1 = c2; c2 = t; }
+  edge = rowMask(r1, r1) | rowMask(r2, r2); // top and bottom edges
+  side = rowMask(r1, r2);                   // left and right sides
+
+  drawStart(db, ROP_COPY);
+  for (int16_t c = clipColumn(c1); c <= clipColumn(c2); c++)
+  {
+    uint8_t m = ((c == c1) || (c == c2)) ? side : edge;
+
+    drawColumn(db, c, state ? m : 0, m);
+  }
+  drawEnd(db);
+}
+
+void MD_MAX72XX::fillRect(int8_t r1, int16_t c1, int8_t r2, int16_t c2, bool state)
+{
+  drawBatch_t db;
+  uint8_t m = rowMask(r1, r2);
+
+  PRINT("\nfillRect: (", r1);
+  PRINT(", ", c1);
+  PRINT(") to (", r2);
+  PRINT(", ", c2);
+  PRINTS(")");
+
+  if (c1 > c2) { int16_t t = c1; c1 = c2; c2 = t; }
+
+  drawStart(db, ROP_COPY);
+  for (int16_t c = clipColumn(c1); c <= clipColumn(c2); c++)
+    drawColumn(db, c, state ? m : 0, m);
+  drawEnd(db);
+}
+
+void MD_MAX72XX::circle(int8_t r, int16_t c, uint8_t radius, bool state, bool fill)
+// Work out the columns of the circle on each display row using the midpoint
+// circle algorithm, then draw the display one column at a time. For each row
+// the circle has one span of columns on the left (up to c) and one on the right.
+{
+  drawBatch_t db;
+  int16_t leftMin[ROW_SIZE], leftMax[ROW_SIZE];
+  int16_t rightMin[ROW_SIZE], rightMax[ROW_SIZE];
+  int16_t x = radius, y = 0;
+  int16_t err = 1 - x;
+
+  for (uint8_t i=0; i<ROW_SIZE; i++)
+  {
+    leftMin[i] = rightMin[i] = INT16_MAX;
+    leftMax[i] = rightMax[i] = INT16_MIN;
+  }
+
+  while (x >= y)
+  {
+    // the 8 symmetric points of this step
+    for (uint8_t i=0; i<8; i++)
+    {
+      int16_t dr = (i & 4) ? x : y;   // row and column offsets from the center
+      int16_t dc = (i & 4) ? y : x;
+
+      if (i & 2) dr = -dr;
+      if (i & 1) dc = -dc;
+
+      int16_t pr = r + dr;
+      int16_t pc = clipColumn((int32_t)c + dc);
+
+      if ((pr < 0) || (pr >= ROW_SIZE))
+        continue;
+
+      if (dc <= 0)
+      {
+        if (pc < leftMin[pr]) leftMin[pr] = pc;
+        if (pc > leftMax[pr]) leftMax[pr] = pc;
+      }
+      else
+      {
+        if (pc < rightMin[pr]) rightMin[pr] = pc;
+        if (pc > rightMax[pr]) rightMax[pr] = pc;
+      }
+    }
+
+    y++;
+    if (err < 0)
+      err += 2 * y + 1;
+    else
+    {
+      x--;
+      err += 2 * (y - x) + 1;
+    }
+  }
+
+  if (fill)   // one span for the whole row between the outside edges
+  {
+    for (uint8_t i=0; i<ROW_SIZE; i++)
+    {
+      if (rightMax[i] > leftMax[i]) leftMax[i] = rightMax[i];
+      rightMin[i] = INT16_MAX;
+      rightMax[i] = INT16_MIN;
+    }
+  }
+
+  drawStart(db, ROP_COPY);
+  for (int16_t col = clipColumn((int32_t)c - radius); col <= clipColumn((int32_t)c + radius); col++)
+  {
+    uint8_t m = 0;
+
+    for (uint8_t i=0; i<ROW_SIZE; i++)
+    {
+      if (((col >= leftMin[i]) && (col <= leftMax[i])) ||
+          ((col >= rightMin[i]) && (col <= rightMax[i])))
+        m |= (1 << i);
+    }
+    drawColumn(db, col, state ? m : 0, m);
+  }
+  drawEnd(db);
+}
+
+bool MD_MAX72XX::floodFill(uint8_t r, uint16_t c, bool state)
+// The area to fill is found one display column at a time. Each column of the
+// area is the set of bits connected vertically to bits of the area in the columns
+// either side. The columns are scanned in both directions until the area does
+// not grow any more, which allows for areas that wrap around other shapes.
+{
+  const uint16_t cols = getColumnCount();
+  drawBatch_t db;
+  uint8_t *area;
+  bool grow;
+
+  PRINT("\nfloodFill: (", r);
+  PRINT(", ", c);
+  PRINT(") = ", state);
+
+  if ((r >= ROW_SIZE) || (c >= cols))
+    return(false);
+
+  if (getPoint(r, c) == state)   // nothing to fill
+    return(true);
+
+  area = (uint8_t *)malloc(cols);
+  if (area == nullptr)
+    return(false);
+  memset(area, 0, cols);
+
+  area[c] = (1 << r);
+  do
+  {
+    grow = false;
+    for (uint8_t pass = 0; pass < 2; pass++)
+    {
+      for (uint16_t i = 0; i < cols; i++)
+      {
+        uint16_t col = (pass == 0) ? i : cols - 1 - i;
+        uint8_t target = state ? ~getColumn(col) : getColumn(col); // pixels that can be filled
+        uint8_t a = area[col];
+
+        // add the bits next to the area in the columns either side
+        if (col > 0) a |= area[col-1];
+        if (col < cols-1) a |= area[col+1];
+        a &= target;
+
+        // and any bits connected vertically
+        if (a != 0)
+        {
+          uint8_t last;
+
+          do
+          {
+            last = a;
+            a = (a | (a << 1) | (a >> 1)) & target;
+          } while (a != last);
+        }
+
+        if (a != area[col])
+        {
+          area[col] = a;
+          grow = true;
+        }
+      }
+    }
+  } while (grow);
+
+  drawStart(db, ROP_COPY);
+  for (uint16_t col = 0; col < cols; col++)
+    drawColumn(db, col, state ? area[col] : 0, area[col]);
+  drawEnd(db);
+
+  free(area);
+
+  return(true);
+}
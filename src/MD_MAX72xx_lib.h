@@ -66,6 +66,8 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
 #define ALL_CLEAR     0x00    ///< Mask for all rows clear in a buffer structure
 
 #define FONT_FILE_INDICATOR 'F' ///< Font table indicator prefix for info header
+#define FONT_RANGE_OFFSET   5   ///< Offset of the range table in a version 3 font table
+#define FONT_RANGE_SIZE     6   ///< Size of each entry in the range table of a version 3 font table
 
 // Shortcuts
 #define SPI_DATA_SIZE (sizeof(uint8_t)*_maxDevices*2)   ///< Size of the SPI data buffers
@@ -395,6 +397,29 @@ One default font is defined as part of the library in PROGMEM memory. Alternativ
 can be specified to the library. The font builder utilities provide a convenient way to
 modify existing or develop alternative fonts.
 
+Version 3: Fonts with character codes in separate ranges (eg, ASCII and a few symbols from
+U+2600) only store the characters that are defined. The font table has a sorted table of the
+ranges of character codes and a directory with the offset of each character, so a character
+is found with a binary search of the ranges and no search of the character data:
+- byte 0 - the character 'F'
+- byte 1 - the version for the file format (3)
+- byte 2 - the height of the character in pixels
+- byte 3 - high byte of the number of ranges (R)
+- byte 4 - low byte of the number of ranges (R)
+- bytes 5..(5+6R-1) - the range table, in increasing order of character code. Each range
+is 6 bytes - the high and low bytes of the first character code in the range, the high and
+low bytes of the last character code in the range, and the high and low bytes of the
+directory entry for the first character in the range. The directory entries for the
+characters in a range are consecutive.
+- the directory - high and low bytes of the offset of each character from the start of the
+character data, one entry for every character in the ranges.
+- the character data - for each character, the number of bytes that form this character
+(could be zero) followed by the column data as for version 2. The characters are stored
+one after the other in the same order as the directory.
+
+The range table and directory must fit in the first 64K bytes of the font table, and the
+offset of each character must fit in 16 bits.
+
 Version 2: Fonts allows for up to 65535 characters in the font table:
 - byte 0 - the character 'F'
 - byte 1 - the version for the file format (2)
@@ -429,7 +454,23 @@ In this case byte 5 of the Version 1 font is the first byte in the file.
 
 To find a character in the font table, the library looks at the first byte (size),
 skips 'size'+1 bytes to the next character size byte and repeat until the last or
-target character is reached.
+target character is reached. If the compile-time switch USE_FONT_INDEX is enabled, this
+search is done once when the font is selected and the offset for each character is kept
+in RAM, making the time to find any character the same. Version 3 fonts are not searched
+and do not need the index.
+
+Font tables do not have to be stored in PROGMEM. Large fonts (eg, with thousands of 16 bit
+characters) can be stored in a file on an SD card or flash file system and selected with
+setFontSource() using an MD_MAX72XX_FileFont object, or loaded into RAM and selected using an
+MD_MAX72XX_MemFont object. The file holds the same bytes as the font data table. The data is
+read in blocks of FONT_READ_AHEAD bytes. For fonts other than version 3 the offset of every
+FONT_SOURCE_STEP'th character is also kept in RAM, so finding any character needs only a few
+reads from the file. This index uses 4 bytes for each entry, for each font in the font cache, so
+it is limited to FONT_SOURCE_INDEX_MAX entries and the entries are further apart in larger fonts.
+If there is not enough RAM for the index the font is read from the start to find a character.
+Large fonts should be version 3 (see the txt2font -s option), as these are found from the
+character directory in the file without an index. On a host computer, MD_MAX72XX_StdioFont
+reads a font file opened with fopen().
 
 The support for fonts (methods and data) may be completely disabled if not required through
 the compile-time switch USE_LOCAL_FONT. This will also disable user defined fonts.
@@ -446,7 +487,9 @@ a version to work with their OS, using the source code supplied.
 
 The application is invoked from the command line and only the root name of the file is given as a command
 line parameter (eg "txt2font fred"). The application will look for and input file with a '.txt' extension
-(fred.txt) and produce an output file with a '.h' extension (fred.h).
+(fred.txt) and produce an output file with a '.h' extension (fred.h). Fonts with character codes up to 255
+are written in the version 1 format. Fonts with larger character codes are written in the version 3 format,
+which can also be selected for any font with the -s option (eg "txt2font -s fred").
 
 The txt2font file format is line based. Lines starting with a '.' are directives for the application, all
 other lines are data for the current character definition. An example of the beginning of a font
@@ -481,8 +524,9 @@ assumes single height font.
 next WIDTH definition. 0 means variable width; any other number defines the fixed width. WIDTH may be changed
 within the file - for example to define a fixed size space (no pixels!) character in a variable width font.
 - .CHAR ends the definition of the current character and starts the definition for the specified ASCII value.
-Valid parameters are [0..255] for single height, and [0..127] for double height. If a character code is
-omitted in the font definition file it is assumed to be empty.
+Valid parameters are [0..65535] for single height, and [0..127] for double height. The value may be decimal
+or hexadecimal with a '0x' prefix (eg, 0x2600). If a character code is omitted in the font definition file it
+is assumed to be empty, and it is left out of a version 3 font table.
 - .NOTE is an option note that will be added as a comment for the entry in the font data table.
 
 Any lines not starting with a '.' are data lines for the current character. The font characters are drawn
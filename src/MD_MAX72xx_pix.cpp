@@ -52,8 +52,34 @@ bool MD_MAX72XX::getBuffer(uint16_t col, uint8_t size, uint8_t *pd)
   if ((col >= getColumnCount()) || (pd == NULL))
     return(false);
 
-  for (uint8_t i=0; i<size; i++)
-    *pd++ = getColumn(col--);
+  if (!_hwDigRows)   // columns are the device digits
+  {
+    for (uint8_t i=0; i<size; i++)
+      *pd++ = getColumn(col--);
+  }
+  else    // transpose the digit rows once for each device
+  {
+    uint8_t data[COL_SIZE];
+    uint8_t lastBuf = 0xff;
+
+    for (uint8_t i=0; i<size; i++, col--)
+    {
+      uint8_t buf = col / COL_SIZE;
+
+      if (buf > LAST_BUFFER)
+        *pd++ = 0;
+      else
+      {
+        if (buf != lastBuf)
+        {
+          loadDigits(buf, data);
+          transpose8(data);
+          lastBuf = buf;
+        }
+        *pd++ = data[col % COL_SIZE];
+      }
+    }
+  }
 
   return(true);
 }
@@ -66,8 +92,33 @@ bool MD_MAX72XX::setBuffer(uint16_t col, uint8_t size, uint8_t *pd)
     return(false);
 
   _updateEnabled = false;
-  for (uint8_t i=0; i<size; i++)
-    setColumn(col--, *pd++);
+  if (!_hwDigRows)   // columns are the device digits
+  {
+    for (uint8_t i=0; i<size; i++)
+      setColumn(col--, *pd++);
+  }
+  else    // transpose the digit rows once for each device
+  {
+    uint8_t data[COL_SIZE];
+
+    for (uint8_t i=0; i<size; )
+    {
+      uint8_t buf = col / COL_SIZE;
+
+      if (buf > LAST_BUFFER)
+        break;
+
+      loadDigits(buf, data);
+      transpose8(data);
+      do
+      {
+        data[col % COL_SIZE] = *pd++;
+        i++;
+      } while ((i < size) && (col-- % COL_SIZE != 0));
+      transpose8(data);
+      storeDigits(buf, data);
+    }
+  }
   _updateEnabled = b;
 
   if (_updateEnabled) flushBufferAll();
@@ -75,6 +126,219 @@ bool MD_MAX72XX::setBuffer(uint16_t col, uint8_t size, uint8_t *pd)
   return(true);
 }
 
+bool MD_MAX72XX::blitDevice(uint8_t buf, uint8_t *data, uint8_t *mask, rasterOp_t rop)
+// Combine the column data for one device with the device digits, where
+// the mask bits are set. data[] and mask[] are in pixel coordinates and are
+// changed by this function. Only the digits that change are marked.
+// Return true if any digit was changed.
+{
+  bool b = false;
+
+  if (_hwDigRows)   // change the columns into rows
+  {
+    transpose8(data);
+    transpose8(mask);
+  }
+
+  for (uint8_t i=0; i<ROW_SIZE; i++)
+  {
+    if (mask[i] == 0)
+      continue;
+
+    const uint8_t m = _hwRevCols ? bitReverse(mask[i]) : mask[i];
+    const uint8_t v = _hwRevCols ? bitReverse(data[i]) : data[i];
+    uint8_t d = _matrix[buf].dig[HW_ROW(i)];
+
+    switch (rop)
+    {
+      case ROP_COPY: d = (d & ~m) | (v & m); break;
+      case ROP_OR:   d |= (v & m);           break;
+      case ROP_AND:  d &= (v | ~m);          break;
+      case ROP_XOR:  d ^= (v & m);           break;
+    }
+
+    if (d != _matrix[buf].dig[HW_ROW(i)])
+    {
+      _matrix[buf].dig[HW_ROW(i)] = d;
+      bitSet(_matrix[buf].changed, HW_ROW(i));
+      b = true;
+    }
+  }
+
+  return(b);
+}
+
+void MD_MAX72XX::drawStart(drawBatch_t &db, rasterOp_t rop)
+// Start collecting pixel data to be combined with the display using rop
+{
+  db.buf = -1;
+  db.rop = rop;
+  db.firstChanged = db.lastChanged = -1;
+}
+
+void MD_MAX72XX::drawColumn(drawBatch_t &db, int16_t c, uint8_t data, uint8_t mask)
+// Add the data for the mask bits of display column c. Data is collected for
+// one device at a time and combined with the device buffer when a column
+// in a different device is added. Columns not on the display are ignored.
+{
+  if ((c < 0) || (c >= (int16_t)getColumnCount()) || (mask == 0))
+    return;
+
+  if (c/COL_SIZE != db.buf)
+  {
+    drawCommit(db);
+    db.buf = c/COL_SIZE;
+    memset(db.data, 0, sizeof(db.data));
+    memset(db.mask, 0, sizeof(db.mask));
+  }
+
+  c %= COL_SIZE;
+  db.data[c] = (db.data[c] & ~mask) | (data & mask);
+  db.mask[c] |= mask;
+}
+
+void MD_MAX72XX::drawCommit(drawBatch_t &db)
+// Combine the data collected for the current device with the device buffer
+{
+  if (db.buf == -1)
+    return;
+
+  if (blitDevice(db.buf, db.data, db.mask, db.rop))
+  {
+    if ((db.firstChanged == -1) || (db.buf < db.firstChanged)) db.firstChanged = db.buf;
+    if ((db.lastChanged == -1) || (db.buf > db.lastChanged)) db.lastChanged = db.buf;
+  }
+  db.buf = -1;
+}
+
+void MD_MAX72XX::drawEnd(drawBatch_t &db)
+// Commit the last data and send all the changes to the devices.
+// A single device is quicker to send on its own.
+{
+  drawCommit(db);
+
+  if (_updateEnabled && db.firstChanged != -1)
+  {
+    if (db.firstChanged == db.lastChanged)
+      flushBuffer(db.firstChanged);
+    else
+      flushBufferAll();
+  }
+}
+
+uint8_t MD_MAX72XX::rowMask(int8_t r1, int8_t r2)
+// Return the bits for rows r1 to r2 (inclusive, in any order) that are on the display
+{
+  if (r1 > r2) { int8_t t = r1; r1 = r2; r2 = t; }
+  if (r1 < 0) r1 = 0;
+  if (r2 >= ROW_SIZE) r2 = ROW_SIZE - 1;
+  if (r1 > r2)
+    return(0);
+
+  return((0xff >> (ROW_SIZE - 1 - (r2 - r1))) << r1);
+}
+
+int16_t MD_MAX72XX::clipColumn(int32_t c)
+// Return column c, or the nearest column just off the display (-1 or
+// getColumnCount()) so loops over clipped columns cannot wrap around
+{
+  if (c < -1) return(-1);
+  if (c > getColumnCount()) return(getColumnCount());
+
+  return(c);
+}
+
+bool MD_MAX72XX::blit(int16_t x, int8_t y, uint8_t w, uint8_t h, const uint8_t *bitmap, rasterOp_t rop)
+{
+  drawBatch_t db;
+  uint8_t mask;
+
+  PRINT("\nblit: (", x);
+  PRINT(", ", y);
+  PRINT(") ", w);
+  PRINT("x", h);
+
+  if ((bitmap == NULL) || (h == 0) || (h > ROW_SIZE) || (rop > ROP_XOR))
+    return(false);
+
+  // the display rows used by the bitmap
+  if (y >= ROW_SIZE || y <= -ROW_SIZE)
+    return(true);
+  mask = rowMask(y, y + h - 1);
+
+  drawStart(db, rop);
+  for (uint8_t i=0; i<w; i++)
+    drawColumn(db, x - i, (y >= 0) ? (bitmap[i] << y) : (bitmap[i] >> -y), mask);
+  drawEnd(db);
+
+  return(true);
+}
+
+bool MD_MAX72XX::setCanvas(const uint8_t *data, uint16_t width, bool progmem)
+{
+  PRINT("\nsetCanvas: ", width);
+
+  if ((data != nullptr) && (width == 0))
+    return(false);
+
+  _canvas.data = data;
+  _canvas.width = width;
+  _canvas.progmem = progmem;
+  _canvas.offset = 0;
+
+  return(true);
+}
+
+bool MD_MAX72XX::setCanvasWindow(uint16_t colStart, uint16_t colEnd)
+{
+  PRINT("\nsetCanvasWindow: ", colStart);
+  PRINT(" to ", colEnd);
+
+  if ((colStart > colEnd) || (colEnd >= getColumnCount()))
+    return(false);
+
+  _canvas.colStart = colStart;
+  _canvas.colEnd = colEnd;
+
+  return(true);
+}
+
+bool MD_MAX72XX::setViewport(int16_t offset)
+// The whole window is drawn from the canvas, but blitDevice() only marks
+// the digits that are different, so only the changes are sent.
+{
+  drawBatch_t db;
+  int32_t i = offset;   // canvas column for the current display column
+
+  PRINT("\nsetViewport: ", offset);
+
+  if (_canvas.data == nullptr)
+    return(false);
+
+  _canvas.offset = offset;
+  if (_wrapAround)
+  {
+    i %= _canvas.width;
+    if (i < 0) i += _canvas.width;
+  }
+
+  drawStart(db, ROP_COPY);
+  for (int32_t c = _canvas.colEnd; c >= _canvas.colStart; c--)
+  {
+    uint8_t data = 0;
+
+    if ((i >= 0) && (i < _canvas.width))
+      data = _canvas.progmem ? pgm_read_byte(_canvas.data + i) : _canvas.data[i];
+    drawColumn(db, c, data, 0xff);
+
+    if ((++i == _canvas.width) && _wrapAround)
+      i = 0;
+  }
+  drawEnd(db);
+
+  return(true);
+}
+
 bool MD_MAX72XX::getPoint(uint8_t r, uint16_t c)
 {
   uint8_t buf = c/COL_SIZE;
@@ -174,11 +438,16 @@ bool MD_MAX72XX::transform(uint8_t startDev, uint8_t endDev, transformType_t tty
       (*_cbShiftDataOut)(endDev, ttype, getColumn(((endDev+1)*COL_SIZE)-1));
 
     // shift all the buffers along
-    for (int8_t buf = endDev; buf >= startDev; --buf)
+    if (_hwDigRows)
+      shiftDigRows(startDev, endDev, ttype);
+    else
     {
-      transformBuffer(buf, ttype);
-      // handle the boundary condition
-      setColumn(buf, 0, getColumn(buf-1, COL_SIZE-1));
+      for (int16_t buf = endDev; buf >= startDev; --buf)
+      {
+        transformBuffer(buf, ttype);
+        // handle the boundary condition
+        setColumn(buf, 0, getColumn(buf-1, COL_SIZE-1));
+      }
     }
 
     // if we have a callback function, now is the time to get the data if we are
@@ -200,12 +469,17 @@ bool MD_MAX72XX::transform(uint8_t startDev, uint8_t endDev, transformType_t tty
       (*_cbShiftDataOut)(startDev, ttype, getColumn((startDev*COL_SIZE)));
 
     // shift all the buffers along
-    for (uint8_t buf=startDev; buf<=endDev; buf++)
+    if (_hwDigRows)
+      shiftDigRows(startDev, endDev, ttype);
+    else
     {
-      transformBuffer(buf, ttype);
+      for (uint8_t buf=startDev; buf<=endDev; buf++)
+      {
+        transformBuffer(buf, ttype);
 
-      // handle the boundary condition
-      setColumn(buf, COL_SIZE-1, getColumn(buf+1, 0));
+        // handle the boundary condition
+        setColumn(buf, COL_SIZE-1, getColumn(buf+1, 0));
+      }
     }
 
     // if we have a callback function, now is the time to get the data if we are
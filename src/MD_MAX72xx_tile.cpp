@@ -0,0 +1,355 @@
+/*
+MD_MAX72xx - Library for using a MAX7219/7221 LED matrix controller
+
+See header file for comments
+
+This file contains methods that map a 2D display made up of rows of
+tiles to the device buffers.
+
+Copyright (C) 2012-14 Marco Colli. All rights reserved.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+#include "MD_MAX72xx.h"
+#include "MD_MAX72xx_lib.h"
+
+/**
+ * \file
+ * \brief Implements 2D tiled display methods
+ */
+
+// Tile map fields. The device row and column for the pixel (xx, yy) in a tile
+// are (yy, xx) swapped for the odd rotations, then XOR with the map values.
+#define TILE_ROT(m)   ((m) >> 6)
+#define TILE_ROWX(m)  (((m) >> 3) & 0x7)
+#define TILE_COLX(m)  ((m) & 0x7)
+
+static const uint8_t tileMap[] =  // map for each tileRotation_t
+{
+  (MD_MAX72XX::ROT_0 << 6)   | (0 << 3) | 7,  // r = yy,   c = 7-xx
+  (MD_MAX72XX::ROT_90 << 6)  | (7 << 3) | 7,  // r = 7-xx, c = 7-yy
+  (MD_MAX72XX::ROT_180 << 6) | (7 << 3) | 0,  // r = 7-yy, c = xx
+  (MD_MAX72XX::ROT_270 << 6) | (0 << 3) | 0,  // r = xx,   c = yy
+};
+
+bool MD_MAX72XX::setGeometry(uint8_t tileCols, uint8_t tileRows, tileWiring_t wiring, const tileRotation_t *rotation)
+{
+  tileInfo_t *tile = nullptr;
+
+  PRINT("\nsetGeometry: ", tileCols);
+  PRINT(" x ", tileRows);
+
+  if (tileRows != 0)
+  {
+    if ((uint16_t)tileCols * tileRows != _maxDevices)
+      return(false);
+
+    tile = (tileInfo_t *)malloc(_maxDevices * sizeof(tileInfo_t));
+    if (tile == nullptr)
+      return(false);
+
+    for (uint8_t dev = 0; dev < _maxDevices; dev++)
+    {
+      uint8_t ty = dev / tileCols;
+      uint8_t tx = dev % tileCols;
+      uint8_t rot = (rotation == nullptr) ? ROT_0 : (rotation[dev] & 0x3);
+
+      // the chain runs right to left, except every second row for serpentine
+      if ((wiring != TILE_SERPENTINE) || ((ty & 1) == 0))
+        tx = tileCols - 1 - tx;
+
+      tile[(ty * tileCols) + tx].dev = dev;
+      tile[(ty * tileCols) + tx].map = tileMap[rot];
+    }
+  }
+  else
+    tileCols = 0;
+
+  free(_tile);
+  _tile = tile;
+  _tileCols = tileCols;
+  _tileRows = tileRows;
+
+  return(true);
+}
+
+bool MD_MAX72XX::setPixel(uint16_t x, uint16_t y, bool state)
+{
+  if ((x >= getWidth()) || (y >= getHeight()))
+    return(false);
+
+  const tileInfo_t &t = _tile[((y / ROW_SIZE) * _tileCols) + (x / COL_SIZE)];
+  const uint8_t xx = x % COL_SIZE;
+  const uint8_t yy = y % ROW_SIZE;
+  const bool swap = (TILE_ROT(t.map) & 1);
+
+  return(setPoint((swap ? xx : yy) ^ TILE_ROWX(t.map), (t.dev * COL_SIZE) + ((swap ? yy : xx) ^ TILE_COLX(t.map)), state));
+}
+
+bool MD_MAX72XX::getPixel(uint16_t x, uint16_t y)
+{
+  if ((x >= getWidth()) || (y >= getHeight()))
+    return(false);
+
+  const tileInfo_t &t = _tile[((y / ROW_SIZE) * _tileCols) + (x / COL_SIZE)];
+  const uint8_t xx = x % COL_SIZE;
+  const uint8_t yy = y % ROW_SIZE;
+  const bool swap = (TILE_ROT(t.map) & 1);
+
+  return(getPoint((swap ? xx : yy) ^ TILE_ROWX(t.map), (t.dev * COL_SIZE) + ((swap ? yy : xx) ^ TILE_COLX(t.map))));
+}
+
+void MD_MAX72XX::loadTile(uint8_t tile, uint8_t *t)
+// Copy the tile to t[] so that bit xx of t[yy] is the pixel (xx, yy) of the tile.
+// The device digits are rows for _hwDigRows hardware and columns otherwise, so
+// only one transpose is needed for DR0 or the odd rotations, and none for both.
+{
+  const uint8_t rot = TILE_ROT(_tile[tile].map);
+
+  loadDigits(_tile[tile].dev, t);
+  if (((rot & 1) != 0) == _hwDigRows) transpose8(t);
+  if ((rot == ROT_90) || (rot == ROT_180)) reverseDigits(t);
+  if ((rot == ROT_0) || (rot == ROT_90))
+  {
+    for (uint8_t i=0; i<ROW_SIZE; i++)
+      t[i] = bitReverse(t[i]);
+  }
+}
+
+void MD_MAX72XX::storeTile(uint8_t tile, const uint8_t *t)
+// Reverse of loadTile().
+{
+  const uint8_t rot = TILE_ROT(_tile[tile].map);
+  uint8_t d[ROW_SIZE];
+
+  for (uint8_t i=0; i<ROW_SIZE; i++)
+    d[i] = ((rot == ROT_0) || (rot == ROT_90)) ? bitReverse(t[i]) : t[i];
+  if ((rot == ROT_90) || (rot == ROT_180)) reverseDigits(d);
+  if (((rot & 1) != 0) == _hwDigRows) transpose8(d);
+  storeDigits(_tile[tile].dev, d);
+}
+
+void MD_MAX72XX::shiftTileRow(uint8_t ty, transformType_t ttype)
+// Shift the tiles one at a time starting from the edge where the new column
+// comes in, carrying the column shifted out of each tile into the next one.
+{
+  const uint8_t first = ty * _tileCols;
+  const uint8_t last = first + _tileCols - 1;
+  const uint8_t outTile = (ttype == TSL) ? first : last;  // column leaves the display here
+  const uint8_t inTile = (ttype == TSL) ? last : first;   // and comes in here
+  uint8_t t[ROW_SIZE];
+  uint8_t colData = 0;
+
+  // work out the column coming in, as for transform()
+  if (_wrapAround || _cbShiftDataOut != NULL)
+  {
+    loadTile(outTile, t);
+    for (uint8_t i=0; i<ROW_SIZE; i++)
+      if (t[i] & ((ttype == TSL) ? 0x01 : 0x80)) colData |= (1 << i);
+
+    if (!_wrapAround)
+    {
+      (*_cbShiftDataOut)(_tile[outTile].dev, ttype, colData);
+      colData = 0;
+    }
+  }
+  if (_cbShiftDataIn != NULL && !_wrapAround)
+    colData = (*_cbShiftDataIn)(_tile[inTile].dev, ttype);
+
+  for (uint8_t i=0; i<_tileCols; i++)
+  {
+    uint8_t tile = (ttype == TSL) ? last - i : first + i;
+    uint8_t carry = 0;
+
+    loadTile(tile, t);
+    for (uint8_t j=0; j<ROW_SIZE; j++)
+    {
+      uint8_t in = (colData >> j) & 1;
+
+      if (ttype == TSL)
+      {
+        carry |= (t[j] & 0x01) << j;
+        t[j] = (t[j] >> 1) | (in << 7);
+      }
+      else
+      {
+        carry |= (t[j] >> 7) << j;
+        t[j] = (t[j] << 1) | in;
+      }
+    }
+    storeTile(tile, t);
+    colData = carry;
+  }
+}
+
+void MD_MAX72XX::shiftTileCol(uint8_t tx, transformType_t ttype)
+// Shift the tiles one at a time starting from the edge where the new row
+// comes in, carrying the row shifted out of each tile into the next one.
+{
+  const uint8_t first = tx;
+  const uint8_t last = ((_tileRows - 1) * _tileCols) + tx;
+  const uint8_t outTile = (ttype == TSU) ? first : last;  // row leaves the display here
+  const uint8_t inTile = (ttype == TSU) ? last : first;   // and comes in here
+  uint8_t t[ROW_SIZE];
+  uint8_t rowData = 0;
+
+  // work out the row coming in, as for the columns in shiftTileRow()
+  if (_wrapAround || _cbShiftDataOut != NULL)
+  {
+    loadTile(outTile, t);
+    rowData = (ttype == TSU) ? t[0] : t[ROW_SIZE-1];
+
+    if (!_wrapAround)
+    {
+      (*_cbShiftDataOut)(_tile[outTile].dev, ttype, rowData);
+      rowData = 0;
+    }
+  }
+  if (_cbShiftDataIn != NULL && !_wrapAround)
+    rowData = (*_cbShiftDataIn)(_tile[inTile].dev, ttype);
+
+  for (uint8_t i=0; i<_tileRows; i++)
+  {
+    uint8_t tile = (ttype == TSU) ? last - (i * _tileCols) : first + (i * _tileCols);
+    uint8_t carry;
+
+    loadTile(tile, t);
+    if (ttype == TSU)
+    {
+      carry = t[0];
+      memmove(&t[0], &t[1], ROW_SIZE-1);
+      t[ROW_SIZE-1] = rowData;
+    }
+    else
+    {
+      carry = t[ROW_SIZE-1];
+      memmove(&t[1], &t[0], ROW_SIZE-1);
+      t[0] = rowData;
+    }
+    storeTile(tile, t);
+    rowData = carry;
+  }
+}
+
+bool MD_MAX72XX::shift2D(int8_t dx, int8_t dy)
+// A diagonal shift is the horizontal shift followed by the vertical shift,
+// sent to the devices once.
+{
+  bool b = _updateEnabled;
+
+  PRINT("\nshift2D: ", dx);
+  PRINT(", ", dy);
+
+  if ((_tile == nullptr) || (dx < -1) || (dx > 1) || (dy < -1) || (dy > 1))
+    return(false);
+
+  _updateEnabled = false;
+
+  if (dx != 0)
+  {
+    for (uint8_t ty=0; ty<_tileRows; ty++)
+      shiftTileRow(ty, (dx < 0) ? TSL : TSR);
+  }
+  if (dy != 0)
+  {
+    for (uint8_t tx=0; tx<_tileCols; tx++)
+      shiftTileCol(tx, (dy < 0) ? TSU : TSD);
+  }
+
+  _updateEnabled = b;
+
+  if (_updateEnabled) flushBufferAll();
+
+  return(true);
+}
+
+bool MD_MAX72XX::transform2D(transformType_t ttype)
+{
+  uint8_t t1[ROW_SIZE], t2[ROW_SIZE];
+  bool b = _updateEnabled;
+
+  PRINT("\ntransform2D: ", ttype);
+
+  if ((_tile == nullptr) || (ttype == TRC) || (ttype > TINV))
+    return(false);
+
+  _updateEnabled = false;
+
+  switch (ttype)
+  {
+    case TSL: // Transform Shift Left one pixel element (with overflow)
+    case TSR: // Transform Shift Right one pixel element (with overflow)
+    case TSU: // Transform Shift Up one pixel element (with overflow)
+    case TSD: // Transform Shift Down one pixel element (with overflow)
+      shift2D((ttype == TSL) ? -1 : ((ttype == TSR) ? 1 : 0), (ttype == TSU) ? -1 : ((ttype == TSD) ? 1 : 0));
+      break;
+
+    case TFLR: // Transform Flip Left to Right - swap the tiles end for end and reverse each row
+      for (uint8_t ty=0; ty<_tileRows; ty++)
+      {
+        for (uint8_t i=0; i<(_tileCols+1)/2; i++)
+        {
+          uint8_t a = (ty * _tileCols) + i;
+          uint8_t z = (ty * _tileCols) + _tileCols - 1 - i;
+
+          loadTile(a, t1);
+          loadTile(z, t2);
+          for (uint8_t j=0; j<ROW_SIZE; j++)
+          {
+            t1[j] = bitReverse(t1[j]);
+            t2[j] = bitReverse(t2[j]);
+          }
+          storeTile(a, t2);
+          if (z != a) storeTile(z, t1);
+        }
+      }
+      break;
+
+    case TFUD: // Transform Flip Up to Down - swap the tiles top to bottom and reverse each column
+      for (uint8_t tx=0; tx<_tileCols; tx++)
+      {
+        for (uint8_t i=0; i<(_tileRows+1)/2; i++)
+        {
+          uint8_t a = (i * _tileCols) + tx;
+          uint8_t z = ((_tileRows - 1 - i) * _tileCols) + tx;
+
+          loadTile(a, t1);
+          loadTile(z, t2);
+          reverseDigits(t1);
+          reverseDigits(t2);
+          storeTile(a, t2);
+          if (z != a) storeTile(z, t1);
+        }
+      }
+      break;
+
+    case TINV: // Transform INVert - the same for every device whatever the geometry
+      for (uint8_t buf = 0; buf < _maxDevices; buf++)
+        transformBuffer(buf, ttype);
+      break;
+
+    default:
+      break;
+  }
+
+  _updateEnabled = b;
+
+  if (_updateEnabled) flushBufferAll();
+
+  return(true);
+}